@@ -37,6 +37,44 @@ enum class TimerType : uint8_t {
   TRIGGER             /**< 触发器 */
 };
 
+/**
+ * @enum ShmLockMode
+ * @brief 表示共享内存段的锁模式。
+ */
+enum class ShmLockMode : uint8_t {
+  SEMAPHORE = 0, /**< 命名信号量互斥，读写均加锁 */
+  SEQLOCK,       /**< 顺序锁，写者递增版本号，读者无锁读取并在版本变化时重试 */
+  ROBUST_MUTEX   /**< 段头部中的进程间健壮互斥锁，支持优先级继承，持锁进程异常退出后可恢复 */
+};
+
+/**
+ * @enum ShmLayout
+ * @brief 表示共享内存话题的数据布局。
+ */
+enum class ShmLayout : uint8_t {
+  SINGLE = 0, /**< 单槽位，新消息覆盖旧消息 */
+  RING,       /**< 多槽位环形缓冲区，订阅者按序读取直到缓冲区溢出 */
+  TRIPLE      /**< 三缓冲最新值，一个写者和一个读者以原子下标交换缓冲区，双方不加锁也互不等待，读者只读取最新的完整消息 */
+};
+
+/**
+ * @enum ShmNotifyMode
+ * @brief 表示共享内存话题的通知方式。
+ */
+enum class ShmNotifyMode : uint8_t {
+  SEMAPHORE = 0, /**< 命名信号量，每次通知唤醒一个订阅者 */
+  FUTEX          /**< 共享内存中的 futex 代数计数器，每次通知唤醒所有订阅者 */
+};
+
+/**
+ * @enum ShmRole
+ * @brief 表示进程在共享内存话题中的角色。
+ */
+enum class ShmRole : uint8_t {
+  PUBLISHER = 0, /**< 发布者 */
+  SUBSCRIBER     /**< 订阅者 */
+};
+
 /**
  * @brief 将定时器类型的字符串表示映射到对应的 `TimerType` 枚举值。
  *
@@ -125,4 +125,58 @@ struct ExecuterConfig {
   std::unordered_map<std::string, GroupSetting> exclusive_task_group; /**< 组名称与其对应的独占任务组设置的映射。 */
 };
 
+/**
+ * @struct SharedMemoryOption
+ * @brief 共享内存段的创建选项。
+ *
+ * 锁模式、布局、容量和大页仅在创建共享内存段时生效；打开已存在的段时以段头部记录的设置为准。
+ * 预填充、内存锁定和锁持有时间统计作用于本进程，发布者和订阅者可分别设置。
+ * 最大交付频率和抽取因子只作用于本进程的订阅者，发布者忽略。
+ * 通知方式需要发布者与订阅者一致。全部为默认值时创建不带头部的裸数据段并使用命名信号量通知，
+ * 与旧版本和 Python 客户端保持兼容。
+ */
+struct SharedMemoryOption {
+  ShmLockMode lock_mode = ShmLockMode::SEMAPHORE;       /**< 共享内存段的锁模式。 */
+  ShmLayout layout = ShmLayout::SINGLE;                 /**< 共享内存话题的数据布局。 */
+  uint32_t slot_count = 16;                             /**< 环形布局下的槽位数量，三缓冲布局固定为 3。 */
+  ShmNotifyMode notify_mode = ShmNotifyMode::SEMAPHORE; /**< 话题的通知方式，默认的信号量每次只唤醒一个订阅者。 */
+  size_t capacity = 0;                                  /**< 单条消息的最大字节数，为 0 时按首条消息的大小创建。 */
+  bool huge_page = false;                               /**< 是否使用大页，hugetlbfs 不可用时回退到透明大页。 */
+  bool populate = false;                                /**< 映射时是否预先填充页表（`MAP_POPULATE`）。 */
+  bool lock_memory = false;                             /**< 是否将映射锁定在物理内存中（`mlock`）。 */
+  bool lock_stats = false;                              /**< 是否统计本进程持有共享内存段锁的时间。 */
+  double max_rate = 0.0;                                /**< 订阅者的最大交付频率（Hz），为 0 时不限制。 */
+  uint32_t decimation = 1;                              /**< 订阅者每隔多少条消息交付一条，为 0 或 1 时交付每条消息。 */
+};
+
+/**
+ * @struct SharedMemoryLockStats
+ * @brief 本进程持有共享内存段锁的时间统计。
+ */
+struct SharedMemoryLockStats {
+  uint64_t count = 0;             /**< 加锁次数。 */
+  uint64_t total_nanoseconds = 0; /**< 累计持锁时间（纳秒）。 */
+  uint64_t max_nanoseconds = 0;   /**< 单次最长持锁时间（纳秒）。 */
+};
+
+/**
+ * @struct SharedMemoryTopicInfo
+ * @brief 共享内存话题注册表中一个话题的快照。
+ *
+ * `option` 记录共享内存段实际使用的锁模式、布局、槽位数量、通知方式和单条消息容量，
+ * 后加入的进程可直接用它构造发布者或订阅者。
+ */
+struct SharedMemoryTopicInfo {
+  std::string topic_name;              /**< 主题名。 */
+  std::string shm_name;                /**< 共享内存段的名称。 */
+  std::string type_name;               /**< 消息类型名称。 */
+  int64_t type_hash = 0;               /**< 消息类型哈希，0 表示未知类型。 */
+  SharedMemoryOption option;           /**< 共享内存段的选项。 */
+  std::vector<int32_t> publisher_pids; /**< 仍在运行的发布者进程号。 */
+  uint32_t subscriber_count = 0;       /**< 仍在运行的订阅者数量。 */
+  uint64_t publish_count = 0;          /**< 累计发布的消息数量。 */
+  uint64_t last_publish_time = 0;      /**< 最近一次发布的时刻，`CLOCK_MONOTONIC` 下的纳秒数，0 表示尚未发布。 */
+  double publish_rate = 0.0;           /**< 近期的发布频率（Hz）。 */
+};
+
 }  // namespace ocm
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <set>
 #include <string>
 #include "common/struct_type.hpp"
+#include "executer/desired_group_data.hpp"
 #include "node/node_map.hpp"
 #include "ocm/atomic_ptr.hpp"
 #include "ocm/shared_memory_topic_lcm.hpp"
@@ -181,14 +182,9 @@ class Executer : public TaskBase {
   bool is_transition_;
 
   /**
-   * @brief 期望任务组的共享内存主题。
+   * @brief 期望任务组主题的订阅者。
    */
-  std::shared_ptr<SharedMemoryTopicLcm> desired_group_topic_lcm_;
-
-  /**
-   * @brief 期望任务组主题的名称。
-   */
-  std::string desired_group_topic_name_;
+  SharedMemorySubscriberLcm<DesiredGroupData> desired_group_subscriber_;
 };
 
 }  // namespace ocm
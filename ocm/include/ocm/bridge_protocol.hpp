@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ocm {
+/**
+ * @brief 桥接数据报的魔数（"OCMB"）。
+ */
+constexpr uint32_t BRIDGE_DATAGRAM_MAGIC = 0x424D434F;
+
+/**
+ * @brief 桥接数据报的格式版本。
+ */
+constexpr uint16_t BRIDGE_DATAGRAM_VERSION = 1;
+
+/**
+ * @brief UDP 数据报的最大负载字节数，超过数据报大小的单条消息单独发送，但不能超过此上限。
+ */
+constexpr size_t BRIDGE_MAX_DATAGRAM_SIZE = 65507;
+
+/**
+ * @brief 桥接数据报头部。
+ *
+ * 每个数据报以该头部开始，随后是 `count` 条消息记录。两端需为相同字节序。
+ */
+struct BridgeDatagramHeader {
+  uint32_t magic;    /**< 魔数。 */
+  uint16_t version;  /**< 格式版本。 */
+  uint16_t count;    /**< 消息记录数量。 */
+  uint32_t sender;   /**< 发送进程号，用于区分不同发送端的序号。 */
+  uint32_t sequence; /**< 数据报序号，接收端据此统计丢失的数据报。 */
+};
+
+/**
+ * @brief 消息记录头部，随后依次是主题名、共享内存段名称和消息数据。
+ */
+struct BridgeRecordHeader {
+  int64_t type_hash;     /**< 消息类型哈希，0 表示未知类型。 */
+  uint32_t payload_size; /**< 消息的字节数。 */
+  uint16_t topic_size;   /**< 主题名的字节数。 */
+  uint16_t shm_size;     /**< 共享内存段名称的字节数。 */
+};
+
+/**
+ * @brief 从数据报中解析出的一条消息记录，各字段指向数据报内部。
+ */
+struct BridgeRecord {
+  std::string_view topic_name;   /**< 主题名。 */
+  std::string_view shm_name;     /**< 共享内存段的名称。 */
+  int64_t type_hash = 0;         /**< 消息类型哈希。 */
+  const uint8_t* data = nullptr; /**< 消息数据。 */
+  size_t size = 0;               /**< 消息的字节数。 */
+};
+
+/**
+ * @class BridgeDatagramBuilder
+ * @brief 将消息记录合并到桥接数据报中。
+ *
+ * 每个数据报在开始时分配序号，发送端按顺序发送即可由接收端统计丢失和乱序。
+ */
+class BridgeDatagramBuilder {
+ public:
+  /**
+   * @brief 构造数据报合并器。
+   *
+   * @param datagram_size 合并时数据报的最大字节数。
+   * @param sender 写入数据报头部的发送端标识，通常为进程号。
+   */
+  BridgeDatagramBuilder(size_t datagram_size, uint32_t sender) : datagram_size_(datagram_size), sender_(sender) {}
+
+  /**
+   * @brief 追加一条消息记录。
+   *
+   * 当前数据报放不下时另起一个数据报；单条记录超过数据报大小时单独成为一个数据报。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param type_hash 消息类型哈希。
+   * @param data 消息数据。
+   * @param size 消息的字节数。
+   * @return 记录超过 UDP 数据报上限而被丢弃时返回 `false`。
+   */
+  bool Add(const std::string& topic_name, const std::string& shm_name, int64_t type_hash, const uint8_t* data, size_t size) {
+    size_t record_size = sizeof(BridgeRecordHeader) + topic_name.size() + shm_name.size() + size;
+    if (sizeof(BridgeDatagramHeader) + record_size > BRIDGE_MAX_DATAGRAM_SIZE) {
+      return false;
+    }
+    if (datagrams_.empty() || GetHeader(datagrams_.back())->count == UINT16_MAX ||
+        (GetHeader(datagrams_.back())->count > 0 && datagrams_.back().size() + record_size > datagram_size_)) {
+      StartDatagram();
+    }
+    auto& datagram = datagrams_.back();
+    BridgeRecordHeader record{type_hash, static_cast<uint32_t>(size), static_cast<uint16_t>(topic_name.size()),
+                              static_cast<uint16_t>(shm_name.size())};
+    const auto* record_bytes = reinterpret_cast<const uint8_t*>(&record);
+    datagram.insert(datagram.end(), record_bytes, record_bytes + sizeof(record));
+    datagram.insert(datagram.end(), topic_name.begin(), topic_name.end());
+    datagram.insert(datagram.end(), shm_name.begin(), shm_name.end());
+    datagram.insert(datagram.end(), data, data + size);
+    GetHeader(datagram)->count += 1;
+    return true;
+  }
+
+  /**
+   * @brief 判断是否有尚未取走的数据报。
+   */
+  bool Empty() const { return datagrams_.empty(); }
+
+  /**
+   * @brief 获取已合并的数据报。
+   */
+  const std::vector<std::vector<uint8_t>>& GetDatagrams() const { return datagrams_; }
+
+  /**
+   * @brief 丢弃已合并的数据报，序号继续递增。
+   */
+  void Clear() { datagrams_.clear(); }
+
+ private:
+  /**
+   * @brief 获取数据报头部。
+   */
+  static BridgeDatagramHeader* GetHeader(std::vector<uint8_t>& datagram) { return reinterpret_cast<BridgeDatagramHeader*>(datagram.data()); }
+
+  /**
+   * @brief 开始一个新的数据报并写入头部。
+   */
+  void StartDatagram() {
+    datagrams_.emplace_back();
+    auto& datagram = datagrams_.back();
+    datagram.reserve(datagram_size_);
+    BridgeDatagramHeader header{BRIDGE_DATAGRAM_MAGIC, BRIDGE_DATAGRAM_VERSION, 0, sender_, sequence_++};
+    const auto* header_bytes = reinterpret_cast<const uint8_t*>(&header);
+    datagram.insert(datagram.end(), header_bytes, header_bytes + sizeof(header));
+  }
+
+  size_t datagram_size_;                        /**< 合并时数据报的最大字节数。 */
+  uint32_t sender_;                             /**< 发送端标识。 */
+  uint32_t sequence_ = 0;                       /**< 下一个数据报的序号。 */
+  std::vector<std::vector<uint8_t>> datagrams_; /**< 尚未取走的数据报。 */
+};
+
+/**
+ * @brief 解析桥接数据报头部。
+ *
+ * @param data 数据报。
+ * @param size 数据报的字节数。
+ * @param header 解析成功时写入头部。
+ * @return 数据报足够长且魔数和版本匹配时返回 `true`。
+ */
+inline bool ParseBridgeDatagramHeader(const uint8_t* data, size_t size, BridgeDatagramHeader* header) {
+  if (size < sizeof(*header)) {
+    return false;
+  }
+  memcpy(header, data, sizeof(*header));
+  return header->magic == BRIDGE_DATAGRAM_MAGIC && header->version == BRIDGE_DATAGRAM_VERSION;
+}
+
+/**
+ * @brief 依次访问桥接数据报中的消息记录。
+ *
+ * 遇到越界的记录时停止，已访问的记录保持有效。
+ *
+ * @tparam Visitor 访问函数类型，签名为 `void(const BridgeRecord&)`。
+ * @param data 数据报，头部需已由 `ParseBridgeDatagramHeader` 检查。
+ * @param size 数据报的字节数。
+ * @param visitor 访问函数。
+ * @return 所有记录都完整时返回 `true`。
+ */
+template <typename Visitor>
+bool ForEachBridgeRecord(const uint8_t* data, size_t size, Visitor&& visitor) {
+  BridgeDatagramHeader header;
+  memcpy(&header, data, sizeof(header));
+  size_t offset = sizeof(header);
+  for (uint16_t n = 0; n < header.count; ++n) {
+    BridgeRecordHeader record_header;
+    if (size - offset < sizeof(record_header)) {
+      return false;
+    }
+    memcpy(&record_header, data + offset, sizeof(record_header));
+    offset += sizeof(record_header);
+    if (size - offset < static_cast<size_t>(record_header.topic_size) + record_header.shm_size + record_header.payload_size) {
+      return false;
+    }
+    BridgeRecord record;
+    record.topic_name = std::string_view(reinterpret_cast<const char*>(data + offset), record_header.topic_size);
+    record.shm_name = std::string_view(reinterpret_cast<const char*>(data + offset + record_header.topic_size), record_header.shm_size);
+    record.type_hash = record_header.type_hash;
+    record.data = data + offset + record_header.topic_size + record_header.shm_size;
+    record.size = record_header.payload_size;
+    offset += record_header.topic_size + record_header.shm_size + record_header.payload_size;
+    visitor(record);
+  }
+  return true;
+}
+
+/**
+ * @class BridgeSequenceTracker
+ * @brief 按发送端跟踪数据报序号，统计丢失和乱序的数据报。
+ *
+ * 序号按 32 位回绕比较：领先期望序号的差值计为丢失，落后的数据报计为乱序或重复，
+ * 迟到的数据报此前已计为丢失，从丢失数中扣除。
+ */
+class BridgeSequenceTracker {
+ public:
+  /**
+   * @brief 记录收到的数据报。
+   *
+   * @param sender 数据报头部中的发送端标识。
+   * @param sequence 数据报序号。
+   */
+  void Track(uint32_t sender, uint32_t sequence) {
+    auto next = next_sequence_.find(sender);
+    if (next == next_sequence_.end()) {
+      next_sequence_.emplace(sender, sequence + 1);
+      return;
+    }
+    int32_t delta = static_cast<int32_t>(sequence - next->second);
+    if (delta >= 0) {
+      lost_ += static_cast<uint64_t>(delta);
+      next->second = sequence + 1;
+    } else {
+      ++reordered_;
+      lost_ -= lost_ > 0 ? 1 : 0;
+    }
+  }
+
+  /**
+   * @brief 获取丢失的数据报数量。
+   */
+  uint64_t GetLostCount() const { return lost_; }
+
+  /**
+   * @brief 获取乱序或重复的数据报数量。
+   */
+  uint64_t GetReorderedCount() const { return reordered_; }
+
+ private:
+  std::unordered_map<uint32_t, uint32_t> next_sequence_; /**< 每个发送端期望的下一个序号。 */
+  uint64_t lost_ = 0;                                    /**< 丢失的数据报数量。 */
+  uint64_t reordered_ = 0;                               /**< 乱序或重复的数据报数量。 */
+};
+
+}  // namespace ocm
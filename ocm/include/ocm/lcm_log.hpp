@@ -0,0 +1,909 @@
+#pragma once
+
+#include <endian.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ocm {
+/**
+ * @brief LCM 日志事件的同步字。
+ */
+inline constexpr uint32_t LCM_LOG_SYNC_WORD = 0xEDA1DA01;
+
+/**
+ * @brief LCM 日志事件头部的字节数：同步字、事件序号、时间戳、频道名长度和数据长度。
+ */
+inline constexpr size_t LCM_LOG_EVENT_HEADER_SIZE = 28;
+
+/**
+ * @brief 旁路索引文件的魔数（"OCMLIDX"）。
+ */
+inline constexpr char LCM_LOG_INDEX_MAGIC[8] = {'O', 'C', 'M', 'L', 'I', 'D', 'X', '\0'};
+
+/**
+ * @brief 旁路索引文件的格式版本。
+ */
+inline constexpr uint32_t LCM_LOG_INDEX_VERSION = 1;
+
+/**
+ * @brief LCM 日志索引中的一项。
+ */
+struct LcmLogIndexEntry {
+  uint64_t offset;   /**< 事件在日志文件中的偏移。 */
+  int64_t timestamp; /**< 事件时间戳（微秒）。 */
+  uint32_t channel;  /**< 频道在 `LcmLogReader::GetChannels` 中的索引。 */
+  uint32_t size;     /**< 事件数据的字节数。 */
+};
+
+static_assert(sizeof(LcmLogIndexEntry) == 24, "LcmLogIndexEntry must be 24 bytes");
+
+/**
+ * @brief 旁路索引文件的头部。
+ *
+ * 旁路索引文件依次为头部、按日志顺序排列的 `LcmLogIndexEntry` 数组和频道表，
+ * 频道表中每个频道依次为 `uint32_t` 长度和频道名，频道在表中的位置即索引项中的频道索引。
+ * 各字段为本机字节序。录制过程中头部的 `log_size` 为 0，正常关闭时才写入，
+ * 因此未完成或已过期的索引与日志文件大小不符，读取时会被忽略。
+ */
+struct LcmLogIndexHeader {
+  char magic[8];                 /**< 魔数。 */
+  uint32_t version;              /**< 格式版本。 */
+  uint32_t channel_count;        /**< 频道数量。 */
+  uint64_t log_size;             /**< 建立索引时日志文件的字节数。 */
+  uint64_t event_count;          /**< 索引项数量。 */
+  uint64_t channel_table_offset; /**< 频道表在索引文件中的偏移。 */
+  uint8_t reserved[24];          /**< 保留字段，填 0。 */
+};
+
+static_assert(sizeof(LcmLogIndexHeader) == 64, "LcmLogIndexHeader must be 64 bytes");
+
+/**
+ * @brief 获取日志文件的旁路索引文件路径。
+ *
+ * @param log_path 日志文件路径。
+ * @return 日志文件路径加 `.idx` 后缀。
+ */
+inline std::string GetLcmLogIndexPath(const std::string& log_path) { return log_path + ".idx"; }
+
+/**
+ * @brief 写入全部数据，被信号中断时继续写入。
+ *
+ * @return 写入成功时返回 `true`，失败时 `errno` 为错误原因。
+ */
+inline bool WriteAll(int fd, const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t result = write(fd, bytes, size);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += result;
+    size -= static_cast<size_t>(result);
+  }
+  return true;
+}
+
+/**
+ * @brief 在旁路索引文件末尾写入频道表，并写入完整的头部。
+ *
+ * @param fd 旁路索引文件，文件位置在索引项数组末尾。
+ * @param channels 频道名。
+ * @param event_count 索引项数量。
+ * @param log_size 日志文件的字节数。
+ * @return 写入成功时返回 `true`。
+ */
+inline bool FinishLcmLogIndex(int fd, const std::vector<std::string>& channels, uint64_t event_count, uint64_t log_size) {
+  LcmLogIndexHeader header{};
+  memcpy(header.magic, LCM_LOG_INDEX_MAGIC, sizeof(header.magic));
+  header.version = LCM_LOG_INDEX_VERSION;
+  header.channel_count = static_cast<uint32_t>(channels.size());
+  header.log_size = log_size;
+  header.event_count = event_count;
+  header.channel_table_offset = sizeof(header) + event_count * sizeof(LcmLogIndexEntry);
+  std::vector<uint8_t> table;
+  for (const auto& channel : channels) {
+    uint32_t length = static_cast<uint32_t>(channel.size());
+    const auto* length_bytes = reinterpret_cast<const uint8_t*>(&length);
+    table.insert(table.end(), length_bytes, length_bytes + sizeof(length));
+    table.insert(table.end(), channel.begin(), channel.end());
+  }
+  return lseek(fd, static_cast<off_t>(header.channel_table_offset), SEEK_SET) >= 0 && WriteAll(fd, table.data(), table.size()) &&
+         pwrite(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header));
+}
+
+/**
+ * @brief LCM 日志写入器的选项。
+ */
+struct LcmLogWriterOption {
+  size_t buffer_size = 4 << 20;        /**< 每个写缓冲区的字节数，缓冲区写满后整体交给写线程。 */
+  size_t buffer_count = 16;            /**< 写缓冲区的数量，写线程落后时最多积压 `buffer_count - 1` 个缓冲区。 */
+  size_t preallocate_size = 256 << 20; /**< 每次预分配的文件空间（字节），为 0 时不预分配。 */
+  bool write_index = false;            /**< 是否在录制的同时写入旁路索引文件，路径见 `GetLcmLogIndexPath`。 */
+};
+
+/**
+ * @brief 与 `lcm::LogFile` 兼容的日志写入器。
+ *
+ * 事件按 LCM 日志格式（大端序的同步字、事件序号、微秒时间戳、频道名长度和数据长度，随后是频道名和数据）
+ * 追加到内存中的写缓冲区，缓冲区写满后由后台写线程以一次 `write` 写入文件，调用线程不做任何文件 I/O。
+ * 写线程提前以 `fallocate` 预分配文件空间，并在写入后立即启动回写，避免脏页堆积后集中刷盘。
+ *
+ * 所有写缓冲区都在积压时，`Append` 丢弃事件并计数而不是等待，调用线程不会被磁盘阻塞。
+ * `Append` 和 `Flush` 只能在同一线程中调用。
+ *
+ * 开启 `write_index` 时，每个写缓冲区附带其中事件的索引项，写线程在写入日志后追加到旁路索引文件，
+ * `Close` 时写入频道表和头部，之后 `LcmLogReader::LoadIndex` 无需扫描日志即可定位。
+ */
+class LcmLogWriter {
+ public:
+  /**
+   * @brief 创建日志文件并启动写线程。
+   *
+   * @param path 日志文件路径，已存在时被截断。
+   * @param option 写入器选项。
+   *
+   * @throws std::runtime_error 如果创建日志文件或旁路索引文件失败。
+   */
+  explicit LcmLogWriter(const std::string& path, const LcmLogWriterOption& option = LcmLogWriterOption{}) : path_(path), option_(option) {
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+      throw std::runtime_error("[LcmLogWriter] Failed to create \"" + path + "\": " + strerror(errno));
+    }
+    if (option_.write_index) {
+      const std::string index_path = GetLcmLogIndexPath(path);
+      index_fd_ = open(index_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      // 先写入未完成的头部，录制中断时索引不会被当作有效索引
+      LcmLogIndexHeader header{};
+      if (index_fd_ < 0 || !WriteAll(index_fd_, &header, sizeof(header))) {
+        std::string error = strerror(errno);
+        close(fd_);
+        if (index_fd_ >= 0) {
+          close(index_fd_);
+        }
+        throw std::runtime_error("[LcmLogWriter] Failed to create \"" + index_path + "\": " + error);
+      }
+    }
+    buffers_.resize(std::max<size_t>(option_.buffer_count, 2));
+    entries_.resize(buffers_.size());
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      buffers_[i].reserve(option_.buffer_size);
+      free_.push_back(i);
+    }
+    thread_ = std::thread([this] { WriteLoop(); });
+  }
+
+  /**
+   * @brief 析构函数，写入剩余的事件并关闭日志文件。
+   */
+  ~LcmLogWriter() { Close(); }
+
+  /**
+   * @brief 删除的拷贝构造函数。
+   */
+  LcmLogWriter(const LcmLogWriter&) = delete;
+
+  /**
+   * @brief 删除的拷贝赋值运算符。
+   */
+  LcmLogWriter& operator=(const LcmLogWriter&) = delete;
+
+  /**
+   * @brief 追加一个事件。
+   *
+   * 事件拷贝到当前写缓冲区后立即返回。超过缓冲区大小的事件独占一个缓冲区。
+   *
+   * @param channel 频道名。
+   * @param timestamp 事件时间戳（微秒）。
+   * @param data 事件数据。
+   * @param size 事件数据的字节数。
+   * @return 没有空闲的写缓冲区或写线程已出错而丢弃事件时返回 `false`。
+   */
+  bool Append(const std::string& channel, int64_t timestamp, const uint8_t* data, size_t size) {
+    size_t event_size = LCM_LOG_EVENT_HEADER_SIZE + channel.size() + size;
+    if (current_ != kNone && !buffers_[current_].empty() && buffers_[current_].size() + event_size > option_.buffer_size) {
+      Flush();
+    }
+    if (failed_.load(std::memory_order_relaxed) || (current_ == kNone && !AcquireBuffer())) {
+      ++dropped_;
+      return false;
+    }
+    auto& buffer = buffers_[current_];
+    size_t offset = buffer.size();
+    buffer.resize(offset + event_size);
+    uint8_t* dst = buffer.data() + offset;
+    PutBigEndian32(dst, LCM_LOG_SYNC_WORD);
+    PutBigEndian64(dst + 4, next_event_++);
+    PutBigEndian64(dst + 12, timestamp);
+    PutBigEndian32(dst + 20, static_cast<uint32_t>(channel.size()));
+    PutBigEndian32(dst + 24, static_cast<uint32_t>(size));
+    memcpy(dst + LCM_LOG_EVENT_HEADER_SIZE, channel.data(), channel.size());
+    memcpy(dst + LCM_LOG_EVENT_HEADER_SIZE + channel.size(), data, size);
+    if (index_fd_ >= 0) {
+      // 索引项的偏移先记录为缓冲区内的偏移，写线程写入时加上缓冲区在文件中的偏移
+      auto channel_id = channel_ids_.find(channel);
+      if (channel_id == channel_ids_.end()) {
+        channel_id = channel_ids_.emplace(channel, static_cast<uint32_t>(channels_.size())).first;
+        channels_.push_back(channel);
+      }
+      entries_[current_].push_back({offset, timestamp, channel_id->second, static_cast<uint32_t>(size)});
+    }
+    return true;
+  }
+
+  /**
+   * @brief 将当前写缓冲区交给写线程，不等待写入完成。
+   *
+   * 用于在事件较少时定期落盘，限制异常退出时丢失的数据量。
+   */
+  void Flush() {
+    if (current_ == kNone || buffers_[current_].empty()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(current_);
+    }
+    current_ = kNone;
+    cond_.notify_one();
+  }
+
+  /**
+   * @brief 写入剩余的事件，停止写线程并关闭日志文件。
+   *
+   * 多次调用时只执行一次。关闭时释放超出文件末尾的预分配空间。
+   */
+  void Close() {
+    if (fd_ < 0) {
+      return;
+    }
+    Flush();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closing_ = true;
+    }
+    cond_.notify_one();
+    thread_.join();
+    if (ftruncate(fd_, static_cast<off_t>(written_.load())) != 0 && !failed_) {
+      SetError("ftruncate");
+    }
+    close(fd_);
+    fd_ = -1;
+    if (index_fd_ >= 0) {
+      if (!failed_ && !FinishLcmLogIndex(index_fd_, channels_, indexed_, written_.load())) {
+        SetError("index");
+      }
+      close(index_fd_);
+      index_fd_ = -1;
+    }
+  }
+
+  /**
+   * @brief 获取已追加的事件数量。
+   */
+  uint64_t GetEventCount() const { return static_cast<uint64_t>(next_event_); }
+
+  /**
+   * @brief 获取因没有空闲写缓冲区或写入失败而丢弃的事件数量。
+   */
+  uint64_t GetDroppedCount() const { return dropped_; }
+
+  /**
+   * @brief 获取已写入文件的字节数。
+   */
+  uint64_t GetWrittenBytes() const { return written_.load(); }
+
+  /**
+   * @brief 获取写线程的错误信息。
+   *
+   * @return 错误信息，未出错时为空。只应在 `Close` 之后或 `Append` 返回 `false` 时读取。
+   */
+  std::string GetError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+  }
+
+ private:
+  /**
+   * @brief 表示没有当前写缓冲区。
+   */
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+  /**
+   * @brief 以大端序写入 32 位整数。
+   */
+  static void PutBigEndian32(uint8_t* dst, uint32_t value) {
+    value = htobe32(value);
+    memcpy(dst, &value, sizeof(value));
+  }
+
+  /**
+   * @brief 以大端序写入 64 位整数。
+   */
+  static void PutBigEndian64(uint8_t* dst, int64_t value) {
+    uint64_t bits = htobe64(static_cast<uint64_t>(value));
+    memcpy(dst, &bits, sizeof(bits));
+  }
+
+  /**
+   * @brief 取一个空闲的写缓冲区作为当前缓冲区。
+   *
+   * @return 没有空闲缓冲区时返回 `false`。
+   */
+  bool AcquireBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+      return false;
+    }
+    current_ = free_.back();
+    free_.pop_back();
+    return true;
+  }
+
+  /**
+   * @brief 记录写线程的错误，之后的事件全部丢弃。
+   */
+  void SetError(const char* operation) {
+    std::string message = "[LcmLogWriter] " + std::string(operation) + " \"" + path_ + "\" failed: " + strerror(errno);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_.empty()) {
+      error_ = message;
+    }
+    failed_ = true;
+  }
+
+  /**
+   * @brief 写线程：依次写入积压的缓冲区，并归还为空闲缓冲区。
+   */
+  void WriteLoop() {
+    while (true) {
+      size_t index = kNone;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return closing_ || !pending_.empty(); });
+        if (pending_.empty()) {
+          return;
+        }
+        index = pending_.front();
+        pending_.pop_front();
+      }
+      auto& buffer = buffers_[index];
+      if (!failed_) {
+        WriteBuffer(buffer.data(), buffer.size(), entries_[index]);
+      }
+      entries_[index].clear();
+      // 超过缓冲区大小的事件使缓冲区扩容，归还前恢复原大小，避免长期占用内存
+      buffer.clear();
+      if (buffer.capacity() > option_.buffer_size) {
+        buffer.shrink_to_fit();
+        buffer.reserve(option_.buffer_size);
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(index);
+    }
+  }
+
+  /**
+   * @brief 将一个缓冲区写入文件，并将其中事件的索引项追加到旁路索引文件。
+   */
+  void WriteBuffer(const uint8_t* data, size_t size, std::vector<LcmLogIndexEntry>& entries) {
+    uint64_t offset = written_.load();
+    if (option_.preallocate_size != 0 && offset + size > allocated_) {
+      size_t length = std::max(option_.preallocate_size, size);
+      if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(allocated_), static_cast<off_t>(length)) == 0) {
+        allocated_ += length;
+      } else {
+        // 文件系统不支持预分配时直接写入
+        option_.preallocate_size = 0;
+      }
+    }
+    if (!WriteAll(fd_, data, size)) {
+      SetError("write");
+      return;
+    }
+    // 立即启动回写，不等待完成
+    sync_file_range(fd_, static_cast<off_t>(offset), static_cast<off_t>(size), SYNC_FILE_RANGE_WRITE);
+    written_.store(offset + size);
+    if (index_fd_ >= 0 && !entries.empty()) {
+      for (auto& entry : entries) {
+        entry.offset += offset;
+      }
+      if (!WriteAll(index_fd_, entries.data(), entries.size() * sizeof(LcmLogIndexEntry))) {
+        SetError("index write");
+        return;
+      }
+      indexed_ += entries.size();
+    }
+  }
+
+  std::string path_;                                      /**< 日志文件路径。 */
+  LcmLogWriterOption option_;                             /**< 写入器选项。 */
+  int fd_ = -1;                                           /**< 日志文件描述符。 */
+  int index_fd_ = -1;                                     /**< 旁路索引文件描述符，不写入索引时为 -1。 */
+  std::vector<std::vector<uint8_t>> buffers_;             /**< 写缓冲区。 */
+  std::vector<std::vector<LcmLogIndexEntry>> entries_;    /**< 每个写缓冲区中事件的索引项，偏移相对于缓冲区。 */
+  std::unordered_map<std::string, uint32_t> channel_ids_; /**< 频道名到频道索引的映射，仅调用线程访问。 */
+  std::vector<std::string> channels_;                     /**< 按首次出现顺序排列的频道名。 */
+  size_t current_ = kNone;                                /**< 调用线程正在填充的缓冲区索引。 */
+  int64_t next_event_ = 0;                                /**< 下一个事件的序号。 */
+  uint64_t dropped_ = 0;                                  /**< 丢弃的事件数量。 */
+  mutable std::mutex mutex_;                              /**< 保护空闲和待写缓冲区队列以及错误信息。 */
+  std::condition_variable cond_;                          /**< 通知写线程有待写缓冲区或需要退出。 */
+  std::vector<size_t> free_;                              /**< 空闲缓冲区索引。 */
+  std::deque<size_t> pending_;                            /**< 待写缓冲区索引，按追加顺序排列。 */
+  bool closing_ = false;                                  /**< 是否正在关闭。 */
+  std::atomic<bool> failed_{false};                       /**< 写线程是否已出错。 */
+  std::string error_;                                     /**< 写线程的错误信息。 */
+  std::atomic<uint64_t> written_{0};                      /**< 已写入文件的字节数。 */
+  uint64_t allocated_ = 0;                                /**< 已预分配的文件空间（字节），仅写线程访问。 */
+  uint64_t indexed_ = 0;                                  /**< 已写入旁路索引文件的索引项数量，仅写线程访问。 */
+  std::thread thread_;                                    /**< 写线程。 */
+};
+
+/**
+ * @brief LCM 日志中的一个事件，频道名和数据直接指向映射的日志文件。
+ */
+struct LcmLogEvent {
+  int64_t event_number = 0;      /**< 事件序号。 */
+  int64_t timestamp = 0;         /**< 事件时间戳（微秒）。 */
+  std::string_view channel;      /**< 频道名。 */
+  const uint8_t* data = nullptr; /**< 事件数据。 */
+  uint32_t size = 0;             /**< 事件数据的字节数。 */
+};
+
+/**
+ * @brief 基于内存映射的 LCM 日志读取器。
+ *
+ * 日志文件以只读方式整体映射，事件的频道名和数据直接指向映射的内存，读取时不拷贝。
+ * 事件索引为每个事件记录偏移、时间戳、频道和数据长度，有两种来源：
+ * - `LoadIndex`：映射录制时写入或此前保存的旁路索引文件，无需访问日志内容；
+ * - `BuildIndex`：扫描日志，只解析事件头部并按数据长度跳过数据，可用 `SaveIndex` 保存供下次使用。
+ *
+ * 有了索引后，`FindTime` 按时间二分定位（时间戳回退时仍然正确），`ForEachEvent` 从任意时刻开始顺序读取，
+ * `ForEachChannelEvent` 只访问一个频道的事件，其他频道的事件所在的页面不被访问。
+ *
+ * 与 `lcm::LogFile` 一致，顺序读取遇到不以同步字开始的数据时向后查找下一个同步字；
+ * 末尾不完整的事件（如录制进程异常退出）被忽略。
+ */
+class LcmLogReader {
+ public:
+  /**
+   * @brief 打开并映射日志文件。
+   *
+   * @param path 日志文件路径。
+   *
+   * @throws std::runtime_error 如果打开或映射日志文件失败。
+   */
+  explicit LcmLogReader(const std::string& path) {
+    if (!MapFile(path, &data_, &size_)) {
+      throw std::runtime_error("[LcmLogReader] Failed to map \"" + path + "\": " + strerror(errno));
+    }
+  }
+
+  /**
+   * @brief 析构函数，解除日志文件和旁路索引文件的映射。
+   */
+  ~LcmLogReader() {
+    if (data_) {
+      munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    if (index_map_) {
+      munmap(const_cast<uint8_t*>(index_map_), index_map_size_);
+    }
+  }
+
+  /**
+   * @brief 删除的拷贝构造函数。
+   */
+  LcmLogReader(const LcmLogReader&) = delete;
+
+  /**
+   * @brief 删除的拷贝赋值运算符。
+   */
+  LcmLogReader& operator=(const LcmLogReader&) = delete;
+
+  /**
+   * @brief 读取偏移处或其后的第一个事件。
+   *
+   * @param offset 开始查找的偏移。
+   * @param event 输出读取的事件。
+   * @param next 输出下一个事件的偏移，可为空。
+   * @return 到达文件末尾或末尾的事件不完整时返回 `false`。
+   */
+  bool ReadEvent(uint64_t offset, LcmLogEvent* event, uint64_t* next = nullptr) const {
+    while (offset + LCM_LOG_EVENT_HEADER_SIZE <= size_) {
+      if (GetBigEndian32(data_ + offset) != LCM_LOG_SYNC_WORD) {
+        offset = FindSyncWord(offset + 1);
+        continue;
+      }
+      return ParseEvent(offset, event, next);
+    }
+    return false;
+  }
+
+  /**
+   * @brief 按索引读取事件。
+   *
+   * @param position 事件在索引中的位置。
+   * @param event 输出读取的事件。
+   * @return 位置越界或索引与日志内容不符时返回 `false`。
+   */
+  bool ReadEventAt(size_t position, LcmLogEvent* event) const {
+    if (position >= index_.size() || index_[position].offset + LCM_LOG_EVENT_HEADER_SIZE > size_ ||
+        GetBigEndian32(data_ + index_[position].offset) != LCM_LOG_SYNC_WORD) {
+      return false;
+    }
+    return ParseEvent(index_[position].offset, event, nullptr);
+  }
+
+  /**
+   * @brief 加载旁路索引文件。
+   *
+   * 索引文件必须完整，且记录的日志大小与当前日志文件一致，否则视为未完成或已过期。
+   *
+   * @param index_path 旁路索引文件路径。
+   * @return 加载成功时返回 `true`；失败时保持原有索引。
+   */
+  bool LoadIndex(const std::string& index_path) {
+    const uint8_t* map = nullptr;
+    size_t map_size = 0;
+    if (!MapFile(index_path, &map, &map_size) || !map) {
+      return false;
+    }
+    LcmLogIndexHeader header;
+    std::vector<std::string> channels;
+    bool valid = map_size >= sizeof(header);
+    if (valid) {
+      memcpy(&header, map, sizeof(header));
+      valid = memcmp(header.magic, LCM_LOG_INDEX_MAGIC, sizeof(header.magic)) == 0 && header.version == LCM_LOG_INDEX_VERSION &&
+              header.log_size == size_ && header.event_count <= (map_size - sizeof(header)) / sizeof(LcmLogIndexEntry) &&
+              header.channel_table_offset == sizeof(header) + header.event_count * sizeof(LcmLogIndexEntry);
+    }
+    uint64_t offset = valid ? header.channel_table_offset : 0;
+    for (uint32_t i = 0; valid && i < header.channel_count; ++i) {
+      uint32_t length = 0;
+      valid = map_size - offset >= sizeof(length);
+      if (valid) {
+        memcpy(&length, map + offset, sizeof(length));
+        offset += sizeof(length);
+        valid = map_size - offset >= length;
+      }
+      if (valid) {
+        channels.emplace_back(reinterpret_cast<const char*>(map + offset), length);
+        offset += length;
+      }
+    }
+    if (!valid) {
+      munmap(const_cast<uint8_t*>(map), map_size);
+      return false;
+    }
+    if (index_map_) {
+      munmap(const_cast<uint8_t*>(index_map_), index_map_size_);
+    }
+    index_map_ = map;
+    index_map_size_ = map_size;
+    built_index_.clear();
+    index_ = std::span<const LcmLogIndexEntry>(reinterpret_cast<const LcmLogIndexEntry*>(map + sizeof(header)), header.event_count);
+    channels_ = std::move(channels);
+    channel_events_.clear();
+    UpdateMaxTimestamps();
+    return true;
+  }
+
+  /**
+   * @brief 扫描日志文件建立事件索引。
+   *
+   * 只读取事件头部和频道名，数据所在的页面不被访问。已有索引时不做任何操作。
+   */
+  void BuildIndex() {
+    if (!index_.empty()) {
+      return;
+    }
+    std::unordered_map<std::string_view, uint32_t> channel_map;
+    LcmLogEvent event;
+    uint64_t offset = 0;
+    uint64_t next = 0;
+    while (ReadEvent(offset, &event, &next)) {
+      auto channel = channel_map.find(event.channel);
+      if (channel == channel_map.end()) {
+        channel = channel_map.emplace(event.channel, static_cast<uint32_t>(channels_.size())).first;
+        channels_.emplace_back(event.channel);
+      }
+      // 同步字可能在 `offset` 之后才找到，由下一个事件的偏移反推本事件的偏移
+      uint64_t event_offset = next - LCM_LOG_EVENT_HEADER_SIZE - event.channel.size() - event.size;
+      built_index_.push_back({event_offset, event.timestamp, channel->second, event.size});
+      offset = next;
+    }
+    index_ = built_index_;
+    channel_events_.clear();
+    UpdateMaxTimestamps();
+  }
+
+  /**
+   * @brief 将事件索引保存为旁路索引文件。
+   *
+   * 先写入临时文件再重命名，并发读取者不会看到不完整的索引。
+   *
+   * @param index_path 旁路索引文件路径。
+   * @return 保存成功时返回 `true`。
+   */
+  bool SaveIndex(const std::string& index_path) const {
+    const std::string temp_path = index_path + ".tmp";
+    int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    LcmLogIndexHeader header{};
+    bool saved = WriteAll(fd, &header, sizeof(header)) && WriteAll(fd, index_.data(), index_.size_bytes()) &&
+                 FinishLcmLogIndex(fd, channels_, index_.size(), size_);
+    saved = close(fd) == 0 && saved;
+    if (!saved || rename(temp_path.c_str(), index_path.c_str()) != 0) {
+      unlink(temp_path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 获取事件索引，按文件中的顺序排列。
+   *
+   * @return 事件索引，加载或建立索引之前为空。
+   */
+  std::span<const LcmLogIndexEntry> GetIndex() const { return index_; }
+
+  /**
+   * @brief 获取日志中出现的频道名，按首次出现的顺序排列。
+   *
+   * @return 频道名，加载或建立索引之前为空。
+   */
+  const std::vector<std::string>& GetChannels() const { return channels_; }
+
+  /**
+   * @brief 查找频道的索引。
+   *
+   * @param channel 频道名。
+   * @return 频道在 `GetChannels` 中的索引，日志中没有该频道时返回 -1。
+   */
+  int FindChannel(std::string_view channel) const {
+    auto found = std::find(channels_.begin(), channels_.end(), channel);
+    return found == channels_.end() ? -1 : static_cast<int>(found - channels_.begin());
+  }
+
+  /**
+   * @brief 查找时间戳不早于指定时刻的第一个事件。
+   *
+   * 日志按录制顺序写入，时间戳可能回退（如各话题的发布时刻交错、墙上时间被校准），不能直接二分。
+   * 改为在各位置之前的最大时间戳上二分：该序列单调不减，第一个不早于指定时刻的位置即为所求。
+   *
+   * @param timestamp 时刻（微秒）。
+   * @return 事件在索引中的位置，所有事件都更早时返回索引的大小。
+   */
+  size_t FindTime(int64_t timestamp) const {
+    return std::lower_bound(max_timestamps_.begin(), max_timestamps_.end(), timestamp) - max_timestamps_.begin();
+  }
+
+  /**
+   * @brief 获取一个频道的所有事件在索引中的位置。
+   *
+   * 首次调用时遍历一次索引，为所有频道建立位置列表及各位置之前的最大时间戳。
+   *
+   * @param channel 频道在 `GetChannels` 中的索引。
+   * @return 按文件顺序排列的事件位置。
+   */
+  const std::vector<size_t>& GetChannelEvents(uint32_t channel) {
+    if (channel_events_.empty()) {
+      channel_events_.resize(channels_.size());
+      channel_max_timestamps_.assign(channels_.size(), {});
+      for (size_t i = 0; i < index_.size(); ++i) {
+        if (index_[i].channel < channel_events_.size()) {
+          auto& max_timestamps = channel_max_timestamps_[index_[i].channel];
+          channel_events_[index_[i].channel].push_back(i);
+          max_timestamps.push_back(max_timestamps.empty() ? index_[i].timestamp : std::max(max_timestamps.back(), index_[i].timestamp));
+        }
+      }
+    }
+    static const std::vector<size_t> kEmpty;
+    return channel < channel_events_.size() ? channel_events_[channel] : kEmpty;
+  }
+
+  /**
+   * @brief 从指定时刻开始按文件顺序读取所有频道的事件。
+   *
+   * @tparam Visitor 访问函数类型，签名为 `bool(const LcmLogEvent& event)`，返回 `false` 时停止。
+   * @param timestamp 开始时刻（微秒）。
+   * @param visitor 访问事件的函数。
+   * @return 访问的事件数量。
+   */
+  template <typename Visitor>
+  size_t ForEachEvent(int64_t timestamp, Visitor&& visitor) const {
+    size_t count = 0;
+    LcmLogEvent event;
+    for (size_t i = FindTime(timestamp); i < index_.size() && ReadEventAt(i, &event); ++i) {
+      ++count;
+      if (!visitor(event)) {
+        break;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * @brief 从指定时刻开始按文件顺序读取一个频道的事件，跳过其他频道。
+   *
+   * @tparam Visitor 访问函数类型，签名为 `bool(const LcmLogEvent& event)`，返回 `false` 时停止。
+   * @param channel 频道在 `GetChannels` 中的索引。
+   * @param timestamp 开始时刻（微秒）。
+   * @param visitor 访问事件的函数。
+   * @return 访问的事件数量。
+   */
+  template <typename Visitor>
+  size_t ForEachChannelEvent(uint32_t channel, int64_t timestamp, Visitor&& visitor) {
+    const auto& positions = GetChannelEvents(channel);
+    auto begin = positions.begin();
+    if (channel < channel_max_timestamps_.size()) {
+      // 与 `FindTime` 相同，在频道内各位置之前的最大时间戳上二分
+      const auto& max_timestamps = channel_max_timestamps_[channel];
+      begin += std::lower_bound(max_timestamps.begin(), max_timestamps.end(), timestamp) - max_timestamps.begin();
+    }
+    size_t count = 0;
+    LcmLogEvent event;
+    for (auto position = begin; position != positions.end() && ReadEventAt(*position, &event); ++position) {
+      ++count;
+      if (!visitor(event)) {
+        break;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * @brief 提示内核预读一段日志，不等待读取完成。
+   *
+   * @param offset 起始偏移。
+   * @param length 预读的字节数。
+   */
+  void Prefetch(uint64_t offset, size_t length) const {
+    if (offset >= size_) {
+      return;
+    }
+    uint64_t begin = offset & ~static_cast<uint64_t>(sysconf(_SC_PAGESIZE) - 1);
+    madvise(const_cast<uint8_t*>(data_) + begin, std::min<uint64_t>(size_ - begin, offset - begin + length), MADV_WILLNEED);
+  }
+
+  /**
+   * @brief 获取日志文件的字节数。
+   */
+  size_t GetSize() const { return size_; }
+
+ private:
+  /**
+   * @brief 以只读方式映射整个文件。
+   *
+   * @param path 文件路径。
+   * @param data 输出映射的内存，文件为空时为空指针。
+   * @param size 输出文件的字节数。
+   * @return 打开或映射失败时返回 `false`，`errno` 为错误原因。
+   */
+  static bool MapFile(const std::string& path, const uint8_t** data, size_t* size) {
+    *data = nullptr;
+    *size = 0;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    bool mapped = fstat(fd, &st) == 0;
+    if (mapped && st.st_size > 0) {
+      void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      mapped = map != MAP_FAILED;
+      if (mapped) {
+        *data = static_cast<const uint8_t*>(map);
+        *size = static_cast<size_t>(st.st_size);
+      }
+    }
+    int error = errno;
+    close(fd);
+    errno = error;
+    return mapped;
+  }
+
+  /**
+   * @brief 计算索引中每个位置及之前事件的最大时间戳。
+   */
+  void UpdateMaxTimestamps() {
+    max_timestamps_.resize(index_.size());
+    int64_t max_timestamp = INT64_MIN;
+    for (size_t i = 0; i < index_.size(); ++i) {
+      max_timestamp = std::max(max_timestamp, index_[i].timestamp);
+      max_timestamps_[i] = max_timestamp;
+    }
+  }
+
+  /**
+   * @brief 以大端序读取 32 位整数。
+   */
+  static uint32_t GetBigEndian32(const uint8_t* src) {
+    uint32_t value;
+    memcpy(&value, src, sizeof(value));
+    return be32toh(value);
+  }
+
+  /**
+   * @brief 以大端序读取 64 位整数。
+   */
+  static uint64_t GetBigEndian64(const uint8_t* src) {
+    uint64_t value;
+    memcpy(&value, src, sizeof(value));
+    return be64toh(value);
+  }
+
+  /**
+   * @brief 解析以同步字开始的事件。
+   *
+   * @return 事件超出文件末尾时返回 `false`。
+   */
+  bool ParseEvent(uint64_t offset, LcmLogEvent* event, uint64_t* next) const {
+    const uint8_t* header = data_ + offset;
+    uint32_t channel_size = GetBigEndian32(header + 20);
+    uint32_t data_size = GetBigEndian32(header + 24);
+    uint64_t end = offset + LCM_LOG_EVENT_HEADER_SIZE + channel_size + data_size;
+    if (end > size_) {
+      return false;
+    }
+    event->event_number = static_cast<int64_t>(GetBigEndian64(header + 4));
+    event->timestamp = static_cast<int64_t>(GetBigEndian64(header + 12));
+    event->channel = std::string_view(reinterpret_cast<const char*>(header + LCM_LOG_EVENT_HEADER_SIZE), channel_size);
+    event->data = header + LCM_LOG_EVENT_HEADER_SIZE + channel_size;
+    event->size = data_size;
+    if (next) {
+      *next = end;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 查找偏移处或其后的第一个同步字。
+   *
+   * @return 同步字的偏移，找不到时返回文件大小。
+   */
+  uint64_t FindSyncWord(uint64_t offset) const {
+    if (offset >= size_) {
+      return size_;
+    }
+    const uint8_t sync[4] = {0xED, 0xA1, 0xDA, 0x01};
+    const void* found = memmem(data_ + offset, size_ - offset, sync, sizeof(sync));
+    return found ? static_cast<const uint8_t*>(found) - data_ : size_;
+  }
+
+  const uint8_t* data_ = nullptr;                            /**< 映射的日志文件。 */
+  size_t size_ = 0;                                          /**< 日志文件的字节数。 */
+  const uint8_t* index_map_ = nullptr;                       /**< 映射的旁路索引文件，未加载时为空。 */
+  size_t index_map_size_ = 0;                                /**< 旁路索引文件的字节数。 */
+  std::vector<LcmLogIndexEntry> built_index_;                /**< `BuildIndex` 建立的事件索引。 */
+  std::span<const LcmLogIndexEntry> index_;                  /**< 当前使用的事件索引，指向 `built_index_` 或映射的旁路索引文件。 */
+  std::vector<std::string> channels_;                        /**< 频道名。 */
+  std::vector<std::vector<size_t>> channel_events_;          /**< 每个频道的事件在索引中的位置，首次按频道访问时建立。 */
+  std::vector<int64_t> max_timestamps_;                      /**< 索引中每个位置及之前事件的最大时间戳，单调不减，供按时间二分查找。 */
+  std::vector<std::vector<int64_t>> channel_max_timestamps_; /**< 每个频道内各位置及之前事件的最大时间戳，与 `channel_events_` 一一对应。 */
+};
+
+}  // namespace ocm
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include "common/prefix_string.hpp"
+#include "common/struct_type.hpp"
+#include "ocm/shared_memory_header.hpp"
 #include "ocm/shared_memory_semaphore.hpp"
 
 namespace ocm {
@@ -12,6 +18,17 @@ namespace ocm {
  *
  * `SharedMemoryData` 类管理共享内存段，提供线程安全的访问和使用信号量进行同步。它通过允许多个进程对共享内存进行读写操作，促进进程间通信。
  *
+ * 以 `ShmLockMode::SEQLOCK` 创建时，段头部中的版本号取代命名信号量：写者在写入前后递增版本号，
+ * 读者通过 `Read` 无锁读取并在读到写入中途的数据时重试，读者不再阻塞写者。
+ *
+ * 以 `ShmLockMode::ROBUST_MUTEX` 创建时，段头部中的进程间互斥锁取代命名信号量。该锁启用优先级继承，
+ * 低优先级进程持锁时会被提升到等待者的优先级，避免实时任务被阻塞；持锁进程异常退出后，下一个加锁者恢复锁，
+ * 并将单槽位数据标记为无效，直到下一次提交。
+ *
+ * 选项 `huge_page` 使新建的段位于 hugetlbfs（`/dev/hugepages`），不可用时回退到普通共享内存并建议内核使用透明大页；
+ * `populate` 和 `lock_memory` 在映射时预先填充页表并锁定物理内存，失败时保持普通映射。
+ * 实际生效的状态可通过 `IsHugePage`、`IsPopulated` 和 `IsMemoryLocked` 查询。
+ *
  * @tparam T 存储在共享内存中的数据类型。
  */
 template <typename T>
@@ -29,8 +46,22 @@ class SharedMemoryData {
    *
    * @throws std::runtime_error 如果初始化失败。
    */
-  SharedMemoryData(const std::string& name, bool check_size, size_t size = 0) : sem_(name + "_shm", 1), data_(nullptr), fd_(0) {
-    Init(name, check_size, size);
+  SharedMemoryData(const std::string& name, bool check_size, size_t size = 0) : SharedMemoryData(name, check_size, size, SharedMemoryOption{}) {}
+
+  /**
+   * @brief 使用创建选项构造一个 SharedMemoryData 实例。
+   *
+   * 选项仅在本实例创建共享内存段时生效；段已存在时沿用段头部记录的设置。
+   *
+   * @param name 共享内存段的标识符。
+   * @param check_size 标志，指示是否验证现有共享内存的大小。
+   * @param size 数据区的大小（以字节为单位），不包含段头部。
+   * @param option 共享内存段的创建选项。
+   *
+   * @throws std::runtime_error 如果初始化失败。
+   */
+  SharedMemoryData(const std::string& name, bool check_size, size_t size, const SharedMemoryOption& option) : data_(nullptr), fd_(0) {
+    Init(name, check_size, size, option);
   }
 
   /**
@@ -44,57 +75,129 @@ class SharedMemoryData {
    * @brief 初始化共享内存段。
    *
    * 打开现有的共享内存段或在不存在时创建一个新的共享内存段。
-   * 可选择检查大小是否与预期大小匹配。
+   * 可选择检查大小是否与预期大小匹配。打开已存在的段时通过头部魔数识别段布局。
+   * 多个进程同时创建时只有一个进程以 `O_EXCL` 创建成功并负责初始化，其余进程打开该段并在有限时间内等待初始化完成。
    *
    * @param name 共享内存段的标识符。
    * @param check_size 标志，指示是否验证现有共享内存的大小。
-   * @param size 共享内存段的大小（以字节为单位）。如果 `check_size` 为真，则需要此参数。
+   * @param size 数据区的大小（以字节为单位）。如果 `check_size` 为真，则需要此参数。
+   * @param option 共享内存段的创建选项。
    *
    * @throws std::runtime_error 如果初始化失败。
    */
-  void Init(const std::string& name, bool check_size, size_t size) {
+  void Init(const std::string& name, bool check_size, size_t size, const SharedMemoryOption& option = SharedMemoryOption{}) {
     assert(!data_);
     bool is_create = false;
+    bool has_header = UseHeader(option);
     name_ = GetNamePrefix(name);
     size_ = size;
 
-    fd_ = shm_open(name_.c_str(), O_RDWR, 0);
-    if (fd_ == -1) {
-      if (errno == ENOENT) {
-        fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT, S_IWUSR | S_IRUSR | S_IWGRP | S_IRGRP | S_IROTH);
-        if (fd_ == -1) {
-          throw std::runtime_error("[SharedMemoryData] Failed to create shared memory \"" + name + "\": " + std::string(strerror(errno)));
-        }
-        if (ftruncate(fd_, size_) != 0) {
-          throw std::runtime_error("[SharedMemoryData] ftruncate failed for \"" + name + "\": " + std::string(strerror(errno)));
+    int map_flags = MAP_SHARED | (option.populate ? MAP_POPULATE : 0);
+    void* mem = MAP_FAILED;
+
+    // 与其他进程同时创建同一个段时，创建者尚未完成初始化
+    bool racing = false;
+    fd_ = OpenSegment();
+    if (fd_ == -1 && errno == ENOENT) {
+      size_t required_size = has_header ? sizeof(SharedMemoryHeader) + size_ : size_;
+      if (option.huge_page) {
+        mem = CreateHugePage(required_size, map_flags);
+      }
+      if (mem == MAP_FAILED && errno != EEXIST) {
+        // 以 O_EXCL 创建，只有一个进程负责初始化
+        fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IWUSR | S_IRUSR | S_IWGRP | S_IRGRP | S_IROTH);
+        if (fd_ != -1) {
+          map_size_ = required_size;
+          if (ftruncate(fd_, map_size_) != 0) {
+            throw std::runtime_error("[SharedMemoryData] ftruncate failed for \"" + name + "\": " + std::string(strerror(errno)));
+          }
         }
+      }
+      if (mem != MAP_FAILED || fd_ != -1) {
         is_create = true;
-      } else {
-        throw std::runtime_error("[SharedMemoryData] shm_open failed for \"" + name + "\": " + std::string(strerror(errno)));
+      } else if (errno == EEXIST) {
+        racing = true;
+        fd_ = OpenSegment();
+      }
+      if (fd_ == -1) {
+        throw std::runtime_error("[SharedMemoryData] Failed to create shared memory \"" + name + "\": " + std::string(strerror(errno)));
+      }
+    } else if (fd_ == -1) {
+      throw std::runtime_error("[SharedMemoryData] shm_open failed for \"" + name + "\": " + std::string(strerror(errno)));
+    }
+    if (!is_create) {
+      map_size_ = WaitSize(name);
+    }
+
+    if (mem == MAP_FAILED) {
+      mem = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, map_flags, fd_, 0);
+      if (mem == MAP_FAILED) {
+        throw std::runtime_error("[SharedMemoryData] mmap failed for \"" + name + "\": " + std::string(strerror(errno)));
+      }
+    }
+    base_ = mem;
+    populated_ = option.populate;
+    if (option.huge_page && !huge_page_) {
+      // 回退到透明大页，内核未启用时忽略
+      madvise(mem, map_size_, MADV_HUGEPAGE);
+    }
+    if (option.lock_memory) {
+      memory_locked_ = mlock(mem, map_size_) == 0;
+    }
+
+    if (is_create) {
+      // 新建的段由内核清零，不再整体清零，以免覆盖其他进程在初始化期间写入的裸数据
+      if (has_header) {
+        header_ = static_cast<SharedMemoryHeader*>(mem);
+        header_->version = SHM_HEADER_VERSION;
+        header_->lock_mode = static_cast<uint8_t>(option.lock_mode);
+        header_->layout = static_cast<uint8_t>(option.layout);
+        header_->payload_capacity = size_;
+        header_->slot_count = option.slot_count;
+        header_->seq.store(0, std::memory_order_relaxed);
+        header_->write_index.store(0, std::memory_order_relaxed);
+        if (option.layout == ShmLayout::TRIPLE) {
+          // 三缓冲布局的 3 个缓冲区初始分别归写者、最新值和读者所有
+          header_->triple_back = 0;
+          header_->triple_latest.store(1, std::memory_order_relaxed);
+          header_->triple_front = 2;
+        }
+        if (option.lock_mode == ShmLockMode::ROBUST_MUTEX) {
+          InitMutex(&header_->mutex);
+        }
+        header_->magic.store(SHM_HEADER_MAGIC, std::memory_order_release);
       }
     } else {
-      struct stat s;
-      if (fstat(fd_, &s)) {
-        throw std::runtime_error("[SharedMemoryData] fstat failed for \"" + name + "\": " + std::string(strerror(errno)));
+      auto* header = static_cast<SharedMemoryHeader*>(mem);
+      if (racing && has_header && map_size_ >= sizeof(SharedMemoryHeader)) {
+        // 等待创建者写入魔数，创建者中途退出时按裸数据布局处理
+        for (int i = 0; i < 100 && header->magic.load(std::memory_order_acquire) != SHM_HEADER_MAGIC; ++i) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+      }
+      if (map_size_ >= sizeof(SharedMemoryHeader) && header->magic.load(std::memory_order_acquire) == SHM_HEADER_MAGIC) {
+        if (header->version != SHM_HEADER_VERSION) {
+          throw std::runtime_error("[SharedMemoryData] Shared memory \"" + name + "\" header version mismatch! Expected: " +
+                                   std::to_string(SHM_HEADER_VERSION) + ", Actual: " + std::to_string(header->version));
+        }
+        header_ = header;
       }
-      if (check_size) {
-        if ((size_t)s.st_size != size_) {
+      size_t actual_size = header_ ? header_->payload_capacity : map_size_;
+      // 带头部的段记录当前消息的有效长度，只需容量足够；环形布局的消息大小由写入方按槽位容量检查
+      if (check_size && GetLayout() == ShmLayout::SINGLE) {
+        if (header_ ? actual_size < size_ : actual_size != size_) {
           throw std::runtime_error("[SharedMemoryData] Existing shared memory \"" + name + "\" size mismatch! Expected: " + std::to_string(size_) +
-                                   ", Actual: " + std::to_string(s.st_size));
+                                   ", Actual: " + std::to_string(actual_size));
         }
-      } else {
-        size_ = s.st_size;
       }
+      size_ = actual_size;
     }
 
-    void* mem = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
-    if (mem == MAP_FAILED) {
-      throw std::runtime_error("[SharedMemoryData] mmap failed for \"" + name + "\": " + std::string(strerror(errno)));
-    }
-    if (is_create) {
-      memset(mem, 0, size_);
+    lock_mode_ = header_ ? static_cast<ShmLockMode>(header_->lock_mode) : ShmLockMode::SEMAPHORE;
+    if (lock_mode_ == ShmLockMode::SEMAPHORE) {
+      sem_ = std::make_shared<SharedMemorySemaphore>(name + "_shm", 1);
     }
-    data_ = static_cast<T*>(mem);
+    data_ = reinterpret_cast<T*>(static_cast<uint8_t*>(mem) + (header_ ? sizeof(SharedMemoryHeader) : 0));
   }
 
   /**
@@ -105,13 +208,16 @@ class SharedMemoryData {
    * @throws std::runtime_error 如果任何清理操作失败。
    */
   void CloseExisting() {
-    sem_.Destroy();
+    if (sem_) {
+      sem_->Destroy();
+    }
     assert(data_);
-    if (munmap(static_cast<void*>(data_), size_) != 0) {
+    if (munmap(base_, map_size_) != 0) {
       throw std::runtime_error("[SharedMemoryData::CloseExisting] munmap failed: " + std::string(strerror(errno)));
     }
     data_ = nullptr;
-    if (shm_unlink(name_.c_str()) != 0) {
+    header_ = nullptr;
+    if ((huge_page_ ? unlink(GetHugePagePath().c_str()) : shm_unlink(name_.c_str())) != 0) {
       if (errno != ENOENT) {
         throw std::runtime_error("[SharedMemoryData::CloseExisting] shm_unlink failed: " + std::string(strerror(errno)));
       }
@@ -131,10 +237,11 @@ class SharedMemoryData {
    */
   void Detach() {
     assert(data_);
-    if (munmap(static_cast<void*>(data_), size_) != 0) {
+    if (munmap(base_, map_size_) != 0) {
       throw std::runtime_error("[SharedMemoryData::Detach] munmap failed: " + std::string(strerror(errno)));
     }
     data_ = nullptr;
+    header_ = nullptr;
     if (close(fd_) != 0) {
       throw std::runtime_error("[SharedMemoryData::Detach] close failed: " + std::string(strerror(errno)));
     }
@@ -154,36 +261,298 @@ class SharedMemoryData {
   }
 
   /**
-   * @brief 获取信号量锁。
+   * @brief 获取写锁。
    *
-   * 减少信号量以获得对共享内存的独占访问权限。
+   * 信号量模式下减少信号量以获得对共享内存的独占访问权限；
+   * 顺序锁模式下将版本号置为奇数，多个写者之间通过比较交换互斥；
+   * 健壮互斥锁模式下锁定段头部中的互斥锁，若上一个持锁进程已退出则恢复锁，并将单槽位数据标记为无效。
+   * 健壮互斥锁须由加锁的线程解锁。
    *
-   * @throws std::runtime_error 如果锁操作失败。
+   * @throws std::runtime_error 如果锁操作失败或互斥锁已不可恢复。
    */
-  void Lock() { sem_.Decrement(); }
+  void Lock() {
+    if (lock_mode_ == ShmLockMode::SEQLOCK) {
+      uint32_t seq = header_->seq.load(std::memory_order_relaxed);
+      while ((seq & 1U) || !header_->seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        std::this_thread::yield();
+        seq = header_->seq.load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_release);
+    } else if (lock_mode_ == ShmLockMode::ROBUST_MUTEX) {
+      int ret = pthread_mutex_lock(&header_->mutex);
+      if (ret == EOWNERDEAD) {
+        // 上一个持锁进程在写入中途退出，数据可能不完整；环形布局中未提交的槽位本就对读者不可见
+        if (GetLayout() == ShmLayout::SINGLE) {
+          header_->payload_invalid = 1;
+        }
+        ret = pthread_mutex_consistent(&header_->mutex);
+      }
+      if (ret != 0) {
+        throw std::runtime_error("[SharedMemoryData] Failed to lock mutex of \"" + name_ + "\": " + std::string(strerror(ret)));
+      }
+    } else {
+      sem_->Decrement();
+    }
+  }
 
   /**
-   * @brief 释放信号量锁。
+   * @brief 释放写锁。
    *
-   * 增加信号量以释放对共享内存的独占访问权限。
+   * 信号量模式下增加信号量；顺序锁模式下将版本号恢复为偶数，发布本次写入；健壮互斥锁模式下解锁互斥锁。
    *
    * @throws std::runtime_error 如果解锁操作失败。
    */
-  void UnLock() { sem_.Increment(); }
+  void UnLock() {
+    if (lock_mode_ == ShmLockMode::SEQLOCK) {
+      header_->seq.fetch_add(1, std::memory_order_release);
+    } else if (lock_mode_ == ShmLockMode::ROBUST_MUTEX) {
+      int ret = pthread_mutex_unlock(&header_->mutex);
+      if (ret != 0) {
+        throw std::runtime_error("[SharedMemoryData] Failed to unlock mutex of \"" + name_ + "\": " + std::string(strerror(ret)));
+      }
+    } else {
+      sem_->Increment();
+    }
+  }
+
+  /**
+   * @brief 以一致的方式读取共享内存。
+   *
+   * 信号量和健壮互斥锁模式下在锁内调用 `reader`；顺序锁模式下不加锁调用 `reader`，
+   * 若期间发生了写入则重新调用，直到读到完整的数据。因此 `reader`
+   * 只应将数据拷贝到调用者的缓冲区，不应产生其他副作用。
+   *
+   * @tparam Reader 读取函数类型，签名为 `void()`。
+   * @param reader 读取函数。
+   */
+  template <typename Reader>
+  void Read(Reader&& reader) {
+    if (lock_mode_ == ShmLockMode::SEQLOCK) {
+      uint32_t seq;
+      do {
+        while ((seq = header_->seq.load(std::memory_order_acquire)) & 1U) {
+          std::this_thread::yield();
+        }
+        reader();
+        std::atomic_thread_fence(std::memory_order_acquire);
+      } while (header_->seq.load(std::memory_order_relaxed) != seq);
+    } else {
+      Lock();
+      reader();
+      UnLock();
+    }
+  }
+
+  /**
+   * @brief 获取共享内存段实际使用的锁模式。
+   *
+   * @return 锁模式。
+   */
+  ShmLockMode GetLockMode() const { return lock_mode_; }
+
+  /**
+   * @brief 获取共享内存段的数据布局。
+   *
+   * @return 数据布局，裸数据布局的段视为单槽位。
+   */
+  ShmLayout GetLayout() const { return header_ ? static_cast<ShmLayout>(header_->layout) : ShmLayout::SINGLE; }
+
+  /**
+   * @brief 获取段头部。
+   *
+   * @return 指向段头部的指针，裸数据布局时返回 `nullptr`。
+   */
+  SharedMemoryHeader* GetHeader() { return header_; }
 
   /**
-   * @brief 获取共享内存段的大小。
+   * @brief 获取共享内存段数据区的大小。
    *
-   * @return 共享内存的大小（以字节为单位）。
+   * @return 数据区的大小（以字节为单位），不包含段头部。
    */
   int GetSize() const { return static_cast<int>(size_); }
 
+  /**
+   * @brief 检查共享内存段是否已存在，不创建新段。
+   *
+   * @param name 共享内存的名称。
+   * @return 普通共享内存或 hugetlbfs 中存在该段时返回 `true`。
+   */
+  static bool Exists(const std::string& name) {
+    const std::string prefixed = GetNamePrefix(name);
+    int fd = shm_open(prefixed.c_str(), O_RDONLY, 0);
+    if (fd != -1) {
+      close(fd);
+      return true;
+    }
+    return access(GetHugePagePath(prefixed).c_str(), F_OK) == 0;
+  }
+
+  /**
+   * @brief 判断共享内存段是否位于 hugetlbfs 大页上。
+   *
+   * @return 段位于 hugetlbfs 时返回 `true`；回退到普通共享内存时返回 `false`。
+   */
+  bool IsHugePage() const { return huge_page_; }
+
+  /**
+   * @brief 判断映射时是否预先填充了页表。
+   *
+   * @return 以 `MAP_POPULATE` 映射时返回 `true`。
+   */
+  bool IsPopulated() const { return populated_; }
+
+  /**
+   * @brief 判断映射是否已锁定在物理内存中。
+   *
+   * @return `mlock` 成功时返回 `true`；未请求或权限、资源限制不足时返回 `false`。
+   */
+  bool IsMemoryLocked() const { return memory_locked_; }
+
  private:
-  SharedMemorySemaphore sem_; /**< 共享内存访问同步的信号量。 */
-  T* data_ = nullptr;         /**< 指向共享内存数据的指针。 */
-  std::string name_;          /**< 共享内存段的标识符。 */
-  size_t size_;               /**< 共享内存段的大小（以字节为单位）。 */
-  int fd_;                    /**< 共享内存的文件描述符。 */
+  /**
+   * @brief 初始化段头部中的进程间健壮互斥锁。
+   *
+   * @param mutex 要初始化的互斥锁。
+   *
+   * @throws std::runtime_error 如果系统不支持进程间共享、优先级继承或健壮互斥锁。
+   */
+  void InitMutex(pthread_mutex_t* mutex) {
+    pthread_mutexattr_t attr;
+    int ret = pthread_mutexattr_init(&attr);
+    if (ret == 0) {
+      ret = pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    }
+    if (ret == 0) {
+      ret = pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    }
+    if (ret == 0) {
+      ret = pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    }
+    if (ret == 0) {
+      ret = pthread_mutex_init(mutex, &attr);
+    }
+    pthread_mutexattr_destroy(&attr);
+    if (ret != 0) {
+      throw std::runtime_error("[SharedMemoryData] Failed to initialize mutex of \"" + name_ + "\": " + std::string(strerror(ret)));
+    }
+  }
+
+  /**
+   * @brief 打开已存在的共享内存段，依次查找普通共享内存和 hugetlbfs。
+   *
+   * @return 文件描述符，两处都不存在时返回 -1 并将 `errno` 置为 `ENOENT`。
+   */
+  int OpenSegment() {
+    int fd = shm_open(name_.c_str(), O_RDWR, 0);
+    huge_page_ = false;
+    if (fd == -1 && errno == ENOENT) {
+      fd = open(GetHugePagePath().c_str(), O_RDWR);
+      huge_page_ = fd != -1;
+      if (fd == -1 && errno != ENOENT) {
+        errno = ENOENT;
+      }
+    }
+    return fd;
+  }
+
+  /**
+   * @brief 获取已存在的共享内存段的大小。
+   *
+   * 创建者在 `O_EXCL` 创建和 `ftruncate` 之间时段大小为 0，此时等待创建者扩展段，等待时间有上限。
+   *
+   * @param name 共享内存段的标识符，用于错误信息。
+   * @return 段的大小（以字节为单位）。
+   *
+   * @throws std::runtime_error 如果 `fstat` 失败或创建者未在时限内扩展段。
+   */
+  size_t WaitSize(const std::string& name) {
+    struct stat s;
+    for (int i = 0; i < 100; ++i) {
+      if (fstat(fd_, &s)) {
+        throw std::runtime_error("[SharedMemoryData] fstat failed for \"" + name + "\": " + std::string(strerror(errno)));
+      }
+      if (s.st_size > 0) {
+        return s.st_size;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    throw std::runtime_error("[SharedMemoryData] Shared memory \"" + name + "\" was not initialized by its creator");
+  }
+
+  /**
+   * @brief 获取共享内存段在 hugetlbfs 中的路径。
+   *
+   * @return 段文件的路径。
+   */
+  std::string GetHugePagePath() const { return GetHugePagePath(name_); }
+
+  /**
+   * @brief 获取带前缀的段名称在 hugetlbfs 中的路径。
+   *
+   * @param prefixed 带前缀的共享内存名称。
+   * @return 段文件的路径。
+   */
+  static std::string GetHugePagePath(const std::string& prefixed) { return "/dev/hugepages/" + prefixed; }
+
+  /**
+   * @brief 在 hugetlbfs 中创建并映射共享内存段。
+   *
+   * 段大小向上取整到大页大小。以 `O_EXCL` 创建，文件已存在时返回 `MAP_FAILED` 并保留 `errno` 为 `EEXIST`；
+   * 其他步骤失败时清理已创建的文件并返回 `MAP_FAILED`，由调用者回退到普通共享内存。
+   *
+   * @param required_size 段的最小大小（以字节为单位），包含段头部。
+   * @param map_flags `mmap` 的标志。
+   * @return 映射的起始地址，失败时返回 `MAP_FAILED`。
+   */
+  void* CreateHugePage(size_t required_size, int map_flags) {
+    const std::string path = GetHugePagePath();
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IWUSR | S_IRUSR | S_IWGRP | S_IRGRP | S_IROTH);
+    if (fd == -1) {
+      return MAP_FAILED;
+    }
+    struct stat s;
+    void* mem = MAP_FAILED;
+    if (fstat(fd, &s) == 0 && s.st_blksize > 0) {
+      size_t page_size = static_cast<size_t>(s.st_blksize);
+      size_t map_size = (required_size + page_size - 1) / page_size * page_size;
+      if (ftruncate(fd, map_size) == 0) {
+        mem = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, map_flags, fd, 0);
+      }
+      if (mem != MAP_FAILED) {
+        fd_ = fd;
+        map_size_ = map_size;
+        huge_page_ = true;
+        return mem;
+      }
+    }
+    close(fd);
+    unlink(path.c_str());
+    return MAP_FAILED;
+  }
+
+  /**
+   * @brief 判断以给定选项创建的段是否需要头部。
+   *
+   * @param option 共享内存段的创建选项。
+   * @return 锁模式、布局、容量和大页均为默认值时返回 `false`，保持裸数据布局。
+   */
+  static bool UseHeader(const SharedMemoryOption& option) {
+    // 大页段的大小按大页取整，需要由头部记录实际容量
+    return option.lock_mode != ShmLockMode::SEMAPHORE || option.layout != ShmLayout::SINGLE || option.capacity != 0 || option.huge_page;
+  }
+
+  std::shared_ptr<SharedMemorySemaphore> sem_;      /**< 信号量模式下共享内存访问同步的信号量。 */
+  SharedMemoryHeader* header_ = nullptr;           /**< 指向段头部的指针，裸数据布局时为空。 */
+  void* base_ = nullptr;                           /**< 映射区域的起始地址。 */
+  T* data_ = nullptr;                              /**< 指向共享内存数据的指针。 */
+  std::string name_;                               /**< 共享内存段的标识符。 */
+  size_t size_;                                    /**< 数据区的大小（以字节为单位）。 */
+  size_t map_size_ = 0;                            /**< 映射区域的大小（以字节为单位），包含段头部。 */
+  ShmLockMode lock_mode_ = ShmLockMode::SEMAPHORE; /**< 实际使用的锁模式。 */
+  int fd_;                                         /**< 共享内存的文件描述符。 */
+  bool huge_page_ = false;                         /**< 段是否位于 hugetlbfs 大页上。 */
+  bool populated_ = false;                         /**< 映射时是否预先填充了页表。 */
+  bool memory_locked_ = false;                     /**< 映射是否已锁定在物理内存中。 */
 };
 
 }  // namespace ocm
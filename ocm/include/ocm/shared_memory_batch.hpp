@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ocm/shared_memory_serializer.hpp"
+
+namespace ocm {
+/**
+ * @brief 批量消息的类型哈希盐值（"BATCH"）。
+ *
+ * 批量消息与单条消息的帧格式不同，类型哈希与盐值异或后写入消息头部，
+ * 单条消息的订阅者读取批量消息时因类型哈希不一致而报错，不会误解码。
+ */
+inline constexpr int64_t SHM_BATCH_HASH_SALT = 0x4241544348LL;
+
+/**
+ * @brief 计算批量消息编码后的字节数。
+ *
+ * 批量消息的帧格式为：`uint32_t` 消息数量，随后每条消息依次为 `uint32_t` 编码长度和编码数据。
+ *
+ * @tparam SerializerPolicy 消息的序列化策略，接口见 `LcmSerializer`。
+ * @tparam MessageType 批量消息的元素类型，可以是消息或指向消息的指针。
+ * @param msgs 要编码的消息。
+ * @param sizes 输出每条消息的编码长度，供 `EncodeBatch` 复用，避免重复计算。
+ * @return 编码后的总字节数。
+ */
+template <template <class> class SerializerPolicy, class MessageType>
+size_t GetBatchEncodedSize(const std::vector<MessageType>& msgs, std::vector<uint32_t>& sizes) {
+  using Serializer = SerializerPolicy<std::remove_cvref_t<decltype(DerefMessage(std::declval<const MessageType&>()))>>;
+  sizes.resize(msgs.size());
+  size_t total = sizeof(uint32_t);
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    sizes[i] = static_cast<uint32_t>(Serializer::GetSize(DerefMessage(msgs[i])));
+    total += sizeof(uint32_t) + sizes[i];
+  }
+  return total;
+}
+
+/**
+ * @brief 将批量消息编码到缓冲区。
+ *
+ * @tparam SerializerPolicy 消息的序列化策略，接口见 `LcmSerializer`。
+ * @tparam MessageType 批量消息的元素类型，可以是消息或指向消息的指针。
+ * @param dst 目标缓冲区，大小不小于 `GetBatchEncodedSize` 的返回值。
+ * @param msgs 要编码的消息。
+ * @param sizes `GetBatchEncodedSize` 输出的每条消息的编码长度。
+ */
+template <template <class> class SerializerPolicy, class MessageType>
+void EncodeBatch(uint8_t* dst, const std::vector<MessageType>& msgs, const std::vector<uint32_t>& sizes) {
+  using Serializer = SerializerPolicy<std::remove_cvref_t<decltype(DerefMessage(std::declval<const MessageType&>()))>>;
+  uint32_t count = static_cast<uint32_t>(msgs.size());
+  memcpy(dst, &count, sizeof(count));
+  dst += sizeof(count);
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    memcpy(dst, &sizes[i], sizeof(uint32_t));
+    dst += sizeof(uint32_t);
+    Serializer::Serialize(DerefMessage(msgs[i]), dst, sizes[i]);
+    dst += sizes[i];
+  }
+}
+
+/**
+ * @brief 依次访问批量消息中的每条消息，不拷贝数据。
+ *
+ * @tparam Visitor 访问函数类型，签名为 `void(const uint8_t* data, size_t size)`。
+ * @param data 批量消息的编码数据。
+ * @param size 批量消息的字节数。
+ * @param visitor 访问每条消息编码数据的函数。
+ * @return 消息数量。
+ *
+ * @throws std::runtime_error 如果批量消息的帧格式与长度不符。
+ */
+template <typename Visitor>
+size_t ForEachBatchMessage(const uint8_t* data, size_t size, Visitor&& visitor) {
+  uint32_t count = 0;
+  if (size < sizeof(count)) {
+    throw std::runtime_error("[ForEachBatchMessage] Batch of " + std::to_string(size) + " bytes is too small");
+  }
+  memcpy(&count, data, sizeof(count));
+  size_t offset = sizeof(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t length = 0;
+    if (size - offset < sizeof(length)) {
+      throw std::runtime_error("[ForEachBatchMessage] Batch is truncated at message " + std::to_string(i));
+    }
+    memcpy(&length, data + offset, sizeof(length));
+    offset += sizeof(length);
+    if (size - offset < length) {
+      throw std::runtime_error("[ForEachBatchMessage] Batch is truncated at message " + std::to_string(i));
+    }
+    visitor(data + offset, static_cast<size_t>(length));
+    offset += length;
+  }
+  return count;
+}
+
+}  // namespace ocm
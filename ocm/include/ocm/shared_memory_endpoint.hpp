@@ -0,0 +1,637 @@
+#pragma once
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/struct_type.hpp"
+#include "ocm/shard_memory_data.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "ocm/shared_memory_registry.hpp"
+#include "ocm/shared_memory_ring.hpp"
+
+namespace ocm {
+/**
+ * @brief 共享内存话题端点。
+ *
+ * `SharedMemoryEndpoint` 持有一个已解析的共享内存段及其布局视图和读取状态，按字节读写消息，
+ * 不涉及消息的序列化方式。共享内存段在首次读写时按名称打开一次，之后的发布和订阅
+ * 直接访问映射后的内存，不再进行字符串查找或分配。
+ *
+ * 带头部的段中每条消息都带有 `SharedMemoryMessageHeader`。读取时先检查消息头部：
+ * 已读过的消息和超过最大时效的消息被跳过，类型哈希不一致时抛出异常，均无需解码。
+ *
+ * 选项中的最大交付频率和抽取因子在订阅路径上生效：限速时等待函数先休眠到下一次允许交付的时刻再等待通知，
+ * 期间的通知合并为一次，环形布局下直接跳到最新消息；抽取时按消息序号跳过中间的消息，跳过的消息不拷贝也不解码。
+ *
+ * 通过 `Advertise` 登记的端点会在 `SharedMemoryRegistry` 中记录话题信息、本进程的角色和发布统计。
+ */
+class SharedMemoryEndpoint {
+ public:
+  /**
+   * @brief 构造共享内存话题端点。
+   *
+   * @param shm_name 共享内存段的名称。
+   * @param option 本端点创建共享内存段时使用的选项。
+   * @param type_hash 消息类型哈希，写入消息头部并用于检查读取的消息，为 0 时不检查。
+   */
+  explicit SharedMemoryEndpoint(const std::string& shm_name, const SharedMemoryOption& option = SharedMemoryOption{}, int64_t type_hash = 0)
+      : shm_name_(shm_name), option_(option), type_hash_(type_hash) {
+    if (option_.layout == ShmLayout::TRIPLE) {
+      option_.slot_count = SHM_TRIPLE_SLOT_COUNT;
+    }
+    option_.decimation = std::max<uint32_t>(option_.decimation, 1);
+    min_interval_ = option_.max_rate > 0.0 ? static_cast<uint64_t>(1e9 / option_.max_rate) : 0;
+  }
+
+  /**
+   * @brief 判断共享内存段是否已打开。
+   *
+   * @return 已打开时返回 `true`。
+   */
+  bool IsOpen() const { return shm_ != nullptr; }
+
+  /**
+   * @brief 打开或创建共享内存段。
+   *
+   * 已打开时不做任何操作。选项中声明了容量时按容量创建，否则按首条消息的大小创建。
+   *
+   * @param check_size 是否检查已存在的共享内存段的大小。
+   * @param size 消息的字节数，用于创建共享内存段。
+   *
+   * @throws std::runtime_error 如果创建或访问共享内存失败。
+   */
+  void Open(bool check_size, size_t size = 0) {
+    if (shm_) {
+      return;
+    }
+    size_t capacity = option_.capacity != 0 ? option_.capacity : size;
+    if (option_.layout == ShmLayout::RING || option_.layout == ShmLayout::TRIPLE) {
+      // 环形和三缓冲布局按槽位容量创建，消息大小在写入时按槽位容量检查
+      shm_ = std::make_shared<SharedMemoryData<uint8_t>>(shm_name_, false, SharedMemoryRing::RegionSize(option_.slot_count, capacity), option_);
+    } else {
+      shm_ = std::make_shared<SharedMemoryData<uint8_t>>(shm_name_, check_size, capacity, option_);
+    }
+    if (shm_->GetLayout() != ShmLayout::SINGLE) {
+      ring_ = std::make_shared<SharedMemoryRing>(shm_->GetHeader(), shm_->Get(), shm_->GetSize());
+    }
+    pid_ = getpid();
+    registration_.Update(GetSegmentOption());
+  }
+
+  /**
+   * @brief 仅在共享内存段已存在时打开，不创建新段。
+   *
+   * 供不知道消息大小的读者在发布者创建共享内存段之后再打开，例如不依赖通知的轮询读者。
+   *
+   * @return 共享内存段已打开时返回 `true`。
+   *
+   * @throws std::runtime_error 如果访问共享内存失败。
+   */
+  bool OpenExisting() {
+    if (!shm_) {
+      if (!SharedMemoryData<uint8_t>::Exists(shm_name_)) {
+        return false;
+      }
+      Open(false);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 在话题注册表中登记本端点。
+   *
+   * 同一角色重复调用时不做任何操作。共享内存段打开后，注册表中的选项更新为段实际使用的设置。
+   *
+   * @param topic_name 主题名。
+   * @param type_name 消息类型名称。
+   * @param role 本进程在话题中的角色。
+   */
+  void Advertise(const std::string& topic_name, const std::string& type_name, ShmRole role) {
+    if (registration_.Register(topic_name, shm_name_, type_name, type_hash_, option_, role) && shm_) {
+      registration_.Update(GetSegmentOption());
+    }
+  }
+
+  /**
+   * @brief 判断是否已以指定角色调用过 `Advertise`。
+   *
+   * @param role 本进程在话题中的角色。
+   * @return 已调用过时返回 `true`。
+   */
+  bool IsAdvertised(ShmRole role) const { return registration_.IsRegistered(role); }
+
+  /**
+   * @brief 写入一条消息。
+   *
+   * 首次写入时按消息大小创建或打开共享内存段，随后在写锁内调用 `writer`；三缓冲布局下不加锁。
+   *
+   * @tparam Writer 写入函数类型，签名为 `void(uint8_t* dst)`。
+   * @param size 消息的字节数。
+   * @param writer 将消息写入 `dst` 的函数。
+   *
+   * @throws std::runtime_error 如果写入共享内存失败。
+   */
+  template <typename Writer>
+  void Write(size_t size, Writer&& writer) {
+    writer(Loan(size));
+    Commit(size);
+  }
+
+  /**
+   * @brief 获取写锁并借出消息数据区，供调用者直接写入。
+   *
+   * 首次调用时按消息大小创建或打开共享内存段。写锁一直持有到 `Commit`，期间其他写者等待。
+   * 健壮互斥锁模式下须在同一线程中调用 `Commit`。三缓冲布局下借出写者独占的缓冲区，不获取写锁。
+   *
+   * @param size 消息的字节数。
+   * @return 指向共享内存中消息数据区的指针。
+   *
+   * @throws std::runtime_error 如果访问共享内存失败、消息超过容量或三缓冲布局已有其他写者。
+   */
+  uint8_t* Loan(size_t size) {
+    Open(true, size);
+    if (!ring_) {
+      if (size > static_cast<size_t>(shm_->GetSize())) {
+        throw std::runtime_error("[SharedMemoryEndpoint] Message of " + std::to_string(size) + " bytes exceeds capacity " +
+                                 std::to_string(shm_->GetSize()) + " of \"" + shm_name_ + "\"");
+      }
+      shm_->Lock();
+      write_lock_time_ = option_.lock_stats ? GetMonotonicTime() : 0;
+      return shm_->Get();
+    }
+    if (ring_->IsTriple()) {
+      return ring_->Loan(size);
+    }
+    shm_->Lock();
+    write_lock_time_ = option_.lock_stats ? GetMonotonicTime() : 0;
+    try {
+      return ring_->Loan(size);
+    } catch (...) {
+      shm_->UnLock();
+      throw;
+    }
+  }
+
+  /**
+   * @brief 提交 `Loan` 借出的消息并释放写锁。
+   *
+   * 带头部的段同时写入消息头部。三缓冲布局下以一次原子交换发布消息，没有需要释放的写锁。
+   *
+   * @param size 消息的有效字节数。
+   */
+  void Commit(size_t size) {
+    SharedMemoryMessageHeader message{};
+    message.timestamp = GetMonotonicTime();
+    message.type_hash = type_hash_;
+    message.payload_size = static_cast<uint32_t>(size);
+    message.pid = pid_;
+    if (ring_ && ring_->IsTriple()) {
+      ring_->Commit(message);
+      registration_.RecordPublish(message.timestamp);
+      return;
+    }
+    if (ring_) {
+      ring_->Commit(message);
+    } else if (auto* header = shm_->GetHeader()) {
+      message.seq = header->message.seq + 1;
+      header->message = message;
+      header->payload_invalid = 0;
+    }
+    if (option_.lock_stats) {
+      RecordLockHold(write_lock_stats_, message.timestamp - write_lock_time_);
+    }
+    shm_->UnLock();
+    registration_.RecordPublish(message.timestamp);
+  }
+
+  /**
+   * @brief 读取消息。
+   *
+   * 先将消息的有效字节拷贝到快照缓冲区：信号量和健壮互斥锁模式下在锁内拷贝，顺序锁模式和环形布局下无锁拷贝，
+   * 三缓冲布局下从读者独占的缓冲区拷贝。
+   * 随后在锁外调用 `decoder` 和 `handler`，解码耗时不计入持锁时间。环形布局下按序读取所有未读消息。
+   *
+   * @tparam Decoder 解码函数类型，签名为 `void(const uint8_t* data, size_t size)`。
+   * @tparam Handler 处理函数类型，签名为 `void()`。
+   * @param decoder 解码消息的函数。
+   * @param handler 处理已解码消息的函数。
+   * @return 读取的消息数量，跳过的消息不计入。
+   *
+   * @throws std::runtime_error 如果消息的类型哈希与本端点不一致。
+   */
+  template <typename Decoder, typename Handler>
+  size_t Read(Decoder&& decoder, Handler&& handler) {
+    return Snapshot([&](const uint8_t* data, size_t size) {
+      decoder(data, size);
+      handler();
+    });
+  }
+
+  /**
+   * @brief 拷贝出消息快照后在锁外读取。
+   *
+   * 每条消息在锁内或顺序锁读取过程中整体拷贝一次到端点的快照缓冲区，随后在锁外调用 `reader`，
+   * 适合解码耗时较长或需要逐段解析的消息，写者不必等待解码完成。环形布局下按序读取所有未读消息。
+   *
+   * @tparam Reader 读取函数类型，签名为 `void(const uint8_t* data, size_t size)`。
+   * @param reader 读取消息快照的函数，`data` 在下一次读取前有效。
+   * @return 读取的消息数量，跳过的消息不计入。
+   *
+   * @throws std::runtime_error 如果消息的类型哈希与本端点不一致。
+   */
+  template <typename Reader>
+  size_t Snapshot(Reader&& reader) {
+    return Visit([this](const uint8_t* data, size_t size) { buffer_.assign(data, data + size); }, [&] { reader(buffer_.data(), buffer_.size()); });
+  }
+
+  /**
+   * @brief 不拷贝地访问共享内存中的消息。
+   *
+   * `viewer` 直接读取共享内存：信号量和健壮互斥锁模式下在锁内调用；顺序锁模式和环形布局下无锁调用，
+   * 若期间被写者覆盖则重新调用，因此 `viewer` 只应读取数据，不应产生副作用；三缓冲布局下在读者独占的缓冲区上调用一次。
+   *
+   * @tparam Viewer 访问函数类型，签名为 `void(const uint8_t* data, size_t size)`。
+   * @param viewer 访问消息的函数。
+   * @return 访问的消息数量，跳过的消息不计入。
+   *
+   * @throws std::runtime_error 如果消息的类型哈希与本端点不一致。
+   */
+  template <typename Viewer>
+  size_t View(Viewer&& viewer) {
+    return Visit(viewer, [] {});
+  }
+
+  /**
+   * @brief 判断 `View` 是否可能对同一条消息重新调用 `viewer`。
+   *
+   * 顺序锁模式和环形布局下无锁读取，读取期间被写者覆盖时重新调用；锁模式和三缓冲布局下每条消息只调用一次。
+   * 需在共享内存段打开后调用。
+   *
+   * @return 可能重新调用时返回 `true`。
+   */
+  bool IsViewRetried() const { return ring_ ? !ring_->IsTriple() : shm_->GetLockMode() == ShmLockMode::SEQLOCK; }
+
+  /**
+   * @brief 判断共享内存段是否带有消息头部。
+   *
+   * 裸数据段没有消息序号，无法按序号判断是否有新消息。需在共享内存段打开后调用。
+   *
+   * @return 带有消息头部时返回 `true`。
+   */
+  bool HasMessageHeader() const { return shm_->GetHeader() != nullptr; }
+
+  /**
+   * @brief 判断共享内存段是否为三缓冲布局。
+   *
+   * 三缓冲布局只允许一个读者，录制、转发等旁路读者应跳过此类话题。需在共享内存段打开后调用。
+   *
+   * @return 三缓冲布局时返回 `true`。
+   */
+  bool IsTriple() const { return ring_ && ring_->IsTriple(); }
+
+  /**
+   * @brief 等待可读取的消息。
+   *
+   * 限速时先休眠到下一次允许交付的时刻。环形布局下已有未读消息时不等待通知，只取走已到达的通知。
+   *
+   * @param notifier 话题的通知器。
+   */
+  void Wait(SharedMemoryNotifier& notifier) {
+    WaitDeliveryTime(UINT64_MAX);
+    if (HasUnread()) {
+      // 取走未读消息对应的通知，发布者据此得知消息已被处理，之后的等待也不会被它唤醒后读不到消息
+      notifier.TryWait();
+    } else {
+      notifier.Wait();
+      Open(false);
+    }
+  }
+
+  /**
+   * @brief 不阻塞地检查是否有可读取的消息。
+   *
+   * 限速时未到下一次允许交付的时刻返回 `false`，不消耗通知。
+   *
+   * @param notifier 话题的通知器。
+   * @return 有可读取的消息时返回 `true`。
+   */
+  bool TryWait(SharedMemoryNotifier& notifier) {
+    if (!IsDeliveryDue()) {
+      return false;
+    }
+    const bool unread = HasUnread();
+    if (notifier.TryWait() || unread) {
+      Open(false);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 在超时时间内等待可读取的消息。
+   *
+   * 限速时先休眠到下一次允许交付的时刻，休眠时间计入超时。
+   *
+   * @param notifier 话题的通知器。
+   * @param timeout 等待的超时时间（毫秒）。
+   * @return 有可读取的消息时返回 `true`，超时时返回 `false`。
+   */
+  bool WaitTimeout(SharedMemoryNotifier& notifier, int timeout) {
+    if (min_interval_ != 0) {
+      uint64_t deadline = GetMonotonicTime() + static_cast<uint64_t>(std::max(timeout, 0)) * 1000000;
+      if (!WaitDeliveryTime(deadline)) {
+        return false;
+      }
+      uint64_t now = GetMonotonicTime();
+      timeout = now < deadline ? static_cast<int>((deadline - now) / 1000000) : 0;
+    }
+    if (HasUnread()) {
+      notifier.TryWait();
+      Open(false);
+      return true;
+    }
+    if (notifier.WaitTimeout(timeout)) {
+      Open(false);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 判断环形或三缓冲布局下是否有未读消息。
+   *
+   * @return 有未读消息时返回 `true`；共享内存段尚未打开或为单槽位布局时返回 `false`。
+   */
+  bool HasUnread() { return ring_ && ring_->HasUnread(cursor_); }
+
+  /**
+   * @brief 获取环形布局下因缓冲区溢出而丢弃的消息数量。
+   *
+   * @return 累计丢弃的消息数量。
+   */
+  uint64_t GetDroppedCount() const { return cursor_.dropped; }
+
+  /**
+   * @brief 设置消息的最大时效。
+   *
+   * 发布时刻距今超过最大时效的消息在读取时被跳过。裸数据段没有消息头部，不受影响。
+   *
+   * @param nanoseconds 最大时效（纳秒），为 0 时不检查。
+   */
+  void SetMaxAge(uint64_t nanoseconds) { max_age_ = nanoseconds; }
+
+  /**
+   * @brief 获取最近一次读取的消息头部。
+   *
+   * 可用于计算端到端延迟：`GetMonotonicTime() - GetMessageHeader().timestamp`。
+   *
+   * @return 消息头部，裸数据段时各字段为 0。
+   */
+  const SharedMemoryMessageHeader& GetMessageHeader() const { return message_; }
+
+  /**
+   * @brief 获取读取时持有共享内存段锁的时间统计。
+   *
+   * 仅在选项开启 `lock_stats` 时统计，无锁读取的顺序锁模式和环形、三缓冲布局不计入。
+   *
+   * @return 读取时的持锁时间统计。
+   */
+  const SharedMemoryLockStats& GetReadLockStats() const { return read_lock_stats_; }
+
+  /**
+   * @brief 获取写入时持有共享内存段锁的时间统计。
+   *
+   * 仅在选项开启 `lock_stats` 时统计，从 `Loan` 获得写锁开始到 `Commit` 释放写锁为止，三缓冲布局不加锁，不计入。
+   *
+   * @return 写入时的持锁时间统计。
+   */
+  const SharedMemoryLockStats& GetWriteLockStats() const { return write_lock_stats_; }
+
+  /**
+   * @brief 判断限速时是否已到下一次允许交付的时刻。
+   *
+   * 未到交付时刻时即使有新消息，`TryWait` 也返回 `false`，等待集据此不将话题视为就绪。
+   *
+   * @return 不限速或已到允许交付的时刻时返回 `true`。
+   */
+  bool IsDeliveryDue() const { return min_interval_ == 0 || GetMonotonicTime() >= next_delivery_time_; }
+
+  /**
+   * @brief 获取限速时下一次允许交付的时刻。
+   *
+   * @return 与 `GetMonotonicTime` 同一时钟的时刻（纳秒），不限速时为 0。
+   */
+  uint64_t GetNextDeliveryTime() const { return next_delivery_time_; }
+
+  /**
+   * @brief 获取 `CLOCK_MONOTONIC` 下的当前时刻，与消息头部的发布时刻可直接比较。
+   *
+   * @return 当前时刻（纳秒）。
+   */
+  static uint64_t GetMonotonicTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+ private:
+  /**
+   * @brief 限速时休眠到下一次允许交付的时刻。
+   *
+   * 休眠期间不等待通知，发布者的通知在信号量或通知代数中合并，不唤醒本订阅者。
+   *
+   * @param deadline 最多休眠到的时刻，与 `GetMonotonicTime` 同一时钟。
+   * @return 已到允许交付的时刻时返回 `true`，先到 `deadline` 时返回 `false`。
+   */
+  bool WaitDeliveryTime(uint64_t deadline) {
+    if (IsDeliveryDue()) {
+      return true;
+    }
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(std::min(next_delivery_time_, deadline))));
+    return IsDeliveryDue();
+  }
+
+  /**
+   * @brief 获取共享内存段实际使用的选项。
+   *
+   * @return 以段头部记录的锁模式、布局和槽位数量以及单条消息容量更新后的选项。
+   */
+  SharedMemoryOption GetSegmentOption() {
+    SharedMemoryOption option = option_;
+    option.lock_mode = shm_->GetLockMode();
+    option.layout = shm_->GetLayout();
+    option.capacity = ring_ ? ring_->GetSlotCapacity() : static_cast<size_t>(shm_->GetSize());
+    if (auto* header = shm_->GetHeader()) {
+      option.slot_count = header->slot_count;
+    }
+    return option;
+  }
+
+  /**
+   * @brief 访问下一条或所有未读消息。
+   *
+   * 每条消息先拷贝头部并检查是否应交付，再调用 `viewer`；`viewer` 可能因覆盖而重新调用。
+   * 交付的消息在锁外调用一次 `handler`。限速时未到允许交付的时刻不读取，消息留待下一次读取；
+   * 环形布局下限速时只交付最新一条，抽取时游标直接跳到下一条应交付的消息。
+   *
+   * @param viewer 访问消息数据的函数。
+   * @param handler 消息交付后调用的函数。
+   * @return 交付的消息数量。
+   */
+  template <typename Viewer, typename Handler>
+  size_t Visit(Viewer&& viewer, Handler&& handler) {
+    if (!IsDeliveryDue()) {
+      return 0;
+    }
+    bool delivered = false;
+    if (ring_) {
+      size_t count = 0;
+      while (min_interval_ == 0 || count == 0) {
+        if (min_interval_ != 0) {
+          ring_->Skip(cursor_, UINT64_MAX);
+        } else if (option_.decimation > 1 && delivered_seq_ != 0) {
+          ring_->Skip(cursor_, delivered_seq_ + option_.decimation - 1);  // 环形布局的消息序号为槽位序号加一
+        }
+        if (!ring_->Read(cursor_, [&](const SharedMemoryMessageHeader& message, const uint8_t* src, size_t size) {
+              message_ = message;
+              delivered = Accept();
+              if (delivered) {
+                viewer(src, size);
+              }
+            })) {
+          break;
+        }
+        last_seq_ = message_.seq;
+        if (delivered) {
+          Deliver();
+          handler();
+          ++count;
+        }
+      }
+      return count;
+    }
+    auto* header = shm_->GetHeader();
+    auto visit = [&] {
+      if (header) {
+        message_ = header->message;
+      }
+      // 持锁进程异常退出后的数据不完整，在下一次提交前不交付
+      delivered = !(header && header->payload_invalid) && Accept();
+      if (delivered) {
+        viewer(shm_->Get(), GetPayloadSize());
+      }
+    };
+    if (shm_->GetLockMode() == ShmLockMode::SEQLOCK) {
+      shm_->Read(visit);
+    } else {
+      shm_->Lock();
+      uint64_t locked = option_.lock_stats ? GetMonotonicTime() : 0;
+      try {
+        visit();
+      } catch (...) {
+        shm_->UnLock();
+        throw;
+      }
+      if (option_.lock_stats) {
+        RecordLockHold(read_lock_stats_, GetMonotonicTime() - locked);
+      }
+      shm_->UnLock();
+    }
+    last_seq_ = message_.seq;
+    if (!delivered) {
+      return 0;
+    }
+    Deliver();
+    handler();
+    return 1;
+  }
+
+  /**
+   * @brief 记录一次交付，更新抽取的起点和下一次允许交付的时刻。
+   */
+  void Deliver() {
+    delivered_seq_ = message_.seq;
+    if (min_interval_ != 0) {
+      next_delivery_time_ = GetMonotonicTime() + min_interval_;
+    }
+  }
+
+  /**
+   * @brief 按消息头部判断 `message_` 是否应交付。
+   *
+   * 裸数据段没有消息头部，不检查序号和时效；信号量方式下按读取次数抽取，futex 方式下已由通知器抽取。
+   *
+   * @return 是尚未读过、未被抽取跳过且未过期的消息时返回 `true`。
+   *
+   * @throws std::runtime_error 如果消息的类型哈希与本端点不一致。
+   */
+  bool Accept() {
+    if (!shm_->GetHeader()) {
+      return option_.notify_mode == ShmNotifyMode::FUTEX || ++raw_read_count_ % option_.decimation == 0;
+    }
+    if (message_.seq == 0 || message_.seq == last_seq_) {
+      return false;
+    }
+    if (delivered_seq_ != 0 && message_.seq - delivered_seq_ < option_.decimation) {
+      return false;
+    }
+    if (type_hash_ != 0 && message_.type_hash != 0 && message_.type_hash != type_hash_) {
+      throw std::runtime_error("[SharedMemoryEndpoint] Message type hash mismatch on \"" + shm_name_ + "\"! Expected: " + std::to_string(type_hash_) +
+                               ", Actual: " + std::to_string(message_.type_hash));
+    }
+    return max_age_ == 0 || GetMonotonicTime() - message_.timestamp <= max_age_;
+  }
+
+  /**
+   * @brief 获取单槽位布局下当前消息的有效字节数。
+   *
+   * 带头部的段读取头部记录的消息长度，裸数据段没有长度信息，返回整个数据区的大小。
+   * 调用者需持有锁或处于顺序锁读取过程中。
+   *
+   * @return 当前消息的有效字节数。
+   */
+  size_t GetPayloadSize() const {
+    size_t capacity = shm_->GetSize();
+    auto* header = shm_->GetHeader();
+    return header ? std::min<size_t>(header->message.payload_size, capacity) : capacity;
+  }
+
+  /**
+   * @brief 累计一次持锁时间。
+   *
+   * @param stats 持锁时间统计。
+   * @param nanoseconds 本次持锁时间（纳秒）。
+   */
+  static void RecordLockHold(SharedMemoryLockStats& stats, uint64_t nanoseconds) {
+    stats.count += 1;
+    stats.total_nanoseconds += nanoseconds;
+    stats.max_nanoseconds = std::max(stats.max_nanoseconds, nanoseconds);
+  }
+
+  std::string shm_name_;                           /**< 共享内存段的名称。 */
+  SharedMemoryOption option_;                      /**< 创建共享内存段时使用的选项。 */
+  std::shared_ptr<SharedMemoryData<uint8_t>> shm_; /**< 已打开的共享内存段。 */
+  std::shared_ptr<SharedMemoryRing> ring_;         /**< 环形和三缓冲布局视图，单槽位布局时为空。 */
+  SharedMemoryRing::Cursor cursor_;                /**< 环形布局下的读取游标。 */
+  std::vector<uint8_t> buffer_;                    /**< 读取快照缓冲区。 */
+  int64_t type_hash_;                              /**< 消息类型哈希，为 0 时不检查。 */
+  uint64_t max_age_ = 0;                           /**< 消息的最大时效（纳秒），为 0 时不检查。 */
+  int32_t pid_ = 0;                                /**< 本进程号，写入消息头部。 */
+  uint64_t last_seq_ = 0;                          /**< 最近一次读取的消息序号。 */
+  uint64_t delivered_seq_ = 0;                     /**< 最近一次交付的消息序号，抽取时从此处计数。 */
+  uint64_t raw_read_count_ = 0;                    /**< 裸数据段的读取次数，信号量方式下用于抽取。 */
+  uint64_t min_interval_ = 0;                      /**< 两次交付的最小间隔（纳秒），为 0 时不限速。 */
+  uint64_t next_delivery_time_ = 0;                /**< 限速时下一次允许交付的时刻。 */
+  SharedMemoryMessageHeader message_{};            /**< 最近一次读取的消息头部。 */
+  SharedMemoryRegistration registration_;          /**< 话题注册表中的登记。 */
+  uint64_t write_lock_time_ = 0;                   /**< 本次写锁的获得时刻，用于统计持锁时间。 */
+  SharedMemoryLockStats read_lock_stats_;          /**< 读取时的持锁时间统计。 */
+  SharedMemoryLockStats write_lock_stats_;         /**< 写入时的持锁时间统计。 */
+};
+
+}  // namespace ocm
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pthread.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ocm {
+
+/**
+ * @brief 带头部共享内存段的魔数（"OCMSHM" + 布局版本）。
+ */
+inline constexpr uint64_t SHM_HEADER_MAGIC = 0x4F434D53484D0001ULL;
+
+/**
+ * @brief 共享内存段头部布局版本。
+ *
+ * Python 客户端（`ocm/python/shared_memory_topic`）按固定偏移解析头部，修改布局时需同步更新。
+ */
+inline constexpr uint32_t SHM_HEADER_VERSION = 7;
+
+/**
+ * @brief 消息头部。
+ *
+ * 每条消息前的定长元数据，由发布者在写锁内随消息一同写入。订阅者无需解码即可判断消息是否为新消息、
+ * 发布距今多久以及类型是否匹配。
+ */
+struct SharedMemoryMessageHeader {
+  uint64_t seq;          /**< 消息序号，从 1 开始，0 表示尚无消息。 */
+  uint64_t timestamp;    /**< 发布时刻，`CLOCK_MONOTONIC` 下的纳秒数。 */
+  int64_t type_hash;     /**< 消息类型哈希，0 表示未知类型。 */
+  uint32_t payload_size; /**< 消息的有效字节数。 */
+  int32_t pid;           /**< 发布者进程号。 */
+};
+
+/**
+ * @brief 共享内存段头部。
+ *
+ * 当共享内存段以非默认选项创建时，段的起始位置放置该头部，数据区紧随其后。
+ * 打开已存在的段时通过 `magic` 自动识别头部，因此订阅者无需预先知道发布者使用的模式。
+ * 未携带头部的段保持原有的裸数据布局，以兼容旧版本和 Python 客户端。
+ */
+struct alignas(64) SharedMemoryHeader {
+  std::atomic<uint64_t> magic;           /**< 魔数，创建者写完头部后最后写入。 */
+  uint32_t version;                      /**< 头部布局版本。 */
+  uint8_t lock_mode;                     /**< 锁模式，取值见 `ShmLockMode`。 */
+  uint8_t layout;                        /**< 数据布局，取值见 `ShmLayout`。 */
+  uint8_t payload_invalid;               /**< 持锁进程异常退出后置 1，表示单槽位数据不完整，直到下一次提交。 */
+  uint8_t reserved;                      /**< 保留字段。 */
+  uint64_t payload_capacity;             /**< 数据区容量（字节）。 */
+  uint32_t slot_count;                   /**< 环形布局下的槽位数量。 */
+  alignas(64) std::atomic<uint32_t> seq; /**< 顺序锁版本号，奇数表示正在写入。 */
+  std::atomic<uint64_t> write_index;     /**< 环形和三缓冲布局下下一条消息的序号。 */
+  SharedMemoryMessageHeader message;     /**< 单槽位布局下当前消息的头部。 */
+  pthread_mutex_t mutex;                 /**< 健壮互斥锁模式下的进程间互斥锁。 */
+  std::atomic<uint32_t> triple_latest;   /**< 三缓冲布局下最新消息所在的缓冲区下标，`SHM_TRIPLE_DIRTY` 位表示读者尚未取走。 */
+  uint32_t triple_back;                  /**< 三缓冲布局下写者独占的缓冲区下标。 */
+  uint32_t triple_front;                 /**< 三缓冲布局下读者独占的缓冲区下标。 */
+  std::atomic<uint64_t> triple_writer;   /**< 三缓冲布局下写者视图的登记标识（高 32 位为进程号），0 表示没有写者。 */
+  std::atomic<uint64_t> triple_reader;   /**< 三缓冲布局下读者视图的登记标识（高 32 位为进程号），0 表示没有读者。 */
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "SharedMemoryHeader requires lock-free 32-bit atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "SharedMemoryHeader requires lock-free 64-bit atomics");
+static_assert(sizeof(SharedMemoryHeader) % 64 == 0, "SharedMemoryHeader must keep the payload cache-line aligned");
+
+}  // namespace ocm
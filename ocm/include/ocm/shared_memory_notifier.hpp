@@ -0,0 +1,181 @@
+#pragma once
+
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "common/enum.hpp"
+#include "ocm/shared_memory_semaphore.hpp"
+
+namespace ocm {
+
+/**
+ * @brief futex 通知段的共享状态。
+ */
+struct alignas(64) SharedMemoryNotifyState {
+  std::atomic<uint32_t> generation;     /**< 通知代数，每次通知加一，同时作为 futex 字。 */
+  std::atomic<uint32_t> waiters;        /**< 正在等待的订阅者数量。 */
+  std::atomic<uint32_t> set_generation; /**< 等待集使用的通知代数，与 `generation` 同步递增，同时作为等待集的 futex 字。 */
+  std::atomic<uint32_t> set_waiters;    /**< 正在等待的等待集数量。 */
+  std::atomic<uint32_t> consumed;       /**< 最近一次被订阅者取走的通知代数，发布者据此判断通知是否已被处理。 */
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "SharedMemoryNotifyState requires lock-free 32-bit atomics");
+
+/**
+ * @brief 共享内存话题通知器。
+ *
+ * `SharedMemoryNotifier` 在发布者与订阅者之间传递“有新消息”的通知，支持两种方式：
+ * - `ShmNotifyMode::SEMAPHORE`：命名 POSIX 信号量，与旧版本和 Python 客户端兼容，每次通知只唤醒一个订阅者。
+ * - `ShmNotifyMode::FUTEX`：话题专用共享内存段中的 32 位代数计数器。发布者做一次原子加法，
+ *   仅当有订阅者等待时才进入内核，以一次 `FUTEX_WAKE_BITSET` 唤醒所有等待该代数的订阅者，
+ *   每个订阅者的唤醒不依赖其他订阅者被调度。每个订阅者记录自己已处理的代数，任意数量的订阅者都恰好收到一次通知。
+ *   等待按代数的低 5 位选择 futex 位掩码，唤醒不会打扰已在等待下一代数的订阅者。超时基于 `CLOCK_MONOTONIC`。
+ *   `SharedMemoryWaitSet` 在独立的 futex 字上等待，发布者仅在有等待集等待时才唤醒它们。
+ *   设置抽取因子 n 后，订阅者在等待第 n 次通知对应的位掩码，中间的通知不会唤醒它。
+ */
+class SharedMemoryNotifier {
+ public:
+  /**
+   * @brief 构造话题通知器。
+   *
+   * @param name 话题名称。
+   * @param mode 通知方式，需要发布者与订阅者一致。
+   *
+   * @throws std::runtime_error 如果创建或访问信号量或通知段失败。
+   */
+  SharedMemoryNotifier(const std::string& name, ShmNotifyMode mode = ShmNotifyMode::SEMAPHORE);
+
+  /**
+   * @brief 析构函数。
+   *
+   * 解除通知段的映射，不删除通知段。
+   */
+  ~SharedMemoryNotifier();
+
+  /**
+   * @brief 删除的拷贝构造函数。
+   *
+   * 每个通知器记录自己已处理的通知代数，不可复制。
+   */
+  SharedMemoryNotifier(const SharedMemoryNotifier&) = delete;
+
+  /**
+   * @brief 删除的拷贝赋值运算符。
+   */
+  SharedMemoryNotifier& operator=(const SharedMemoryNotifier&) = delete;
+
+  /**
+   * @brief 通知订阅者有新消息。
+   *
+   * @throws std::runtime_error 如果发送通知失败。
+   */
+  void Notify();
+
+  /**
+   * @brief 阻塞等待通知。
+   *
+   * @throws std::runtime_error 如果等待失败。
+   */
+  void Wait();
+
+  /**
+   * @brief 不阻塞地检查通知。
+   *
+   * @return 有未处理的通知时返回 `true`。
+   */
+  bool TryWait();
+
+  /**
+   * @brief 在超时时间内等待通知。
+   *
+   * @param milliseconds 等待的超时时间（毫秒），按 `CLOCK_MONOTONIC` 计时。
+   * @return 在超时内收到通知时返回 `true`；否则返回 `false`。
+   *
+   * @throws std::runtime_error 如果获取当前时间或等待失败。
+   */
+  bool WaitTimeout(uint64_t milliseconds);
+
+  /**
+   * @brief 检查是否有未处理的通知，不消耗通知。
+   *
+   * @return 有未处理的通知时返回 `true`。
+   */
+  bool IsPending() const;
+
+  /**
+   * @brief 检查最近一次通知是否已被订阅者取走，供发布者按订阅者的处理进度发布。
+   *
+   * 信号量方式下信号量归零即已取走；futex 方式下任一订阅者取走最新代数即为已取走。
+   *
+   * @return 最近一次通知已被取走或尚未通知过时返回 `true`。
+   */
+  bool IsConsumed() const;
+
+  /**
+   * @brief 设置抽取因子：每累计 `count` 次通知才结束一次等待。
+   *
+   * 仅对 futex 方式生效，跳过的通知不唤醒本订阅者，也不进入内核。信号量方式下的命名信号量为二值且由所有订阅者共享，
+   * 无法按订阅者计数，每次通知仍会唤醒，由 `SharedMemoryEndpoint` 按消息序号跳过。等待集仍随每次通知唤醒。
+   *
+   * @param count 抽取因子，为 0 或 1 时每次通知都结束等待。
+   */
+  void SetDecimation(uint32_t count) { decimation_ = std::max<uint32_t>(count, 1); }
+
+  /**
+   * @brief 获取通知方式。
+   *
+   * @return 通知方式。
+   */
+  ShmNotifyMode GetMode() const { return mode_; }
+
+  /**
+   * @brief 销毁通知器。
+   *
+   * 删除命名信号量或通知段，使其从系统中移除。
+   *
+   * @throws std::runtime_error 如果删除失败。
+   */
+  void Destroy();
+
+ private:
+  friend class SharedMemoryWaitSet;
+
+  /**
+   * @brief 等待通知代数前进到抽取因子要求的数量。
+   *
+   * @param deadline `CLOCK_MONOTONIC` 下的绝对截止时间，为空时一直等待。
+   * @return 代数前进足够时返回 `true`，超时时返回 `false`。
+   *
+   * @throws std::runtime_error 如果 futex 等待失败。
+   */
+  bool WaitUntil(const struct timespec* deadline);
+
+  /**
+   * @brief 唤醒等待指定代数的订阅者。
+   *
+   * @param generation 等待者已处理的通知代数。
+   * @param count 最多唤醒的数量。
+   * @return 被唤醒的数量，失败时返回 -1。
+   */
+  long Wake(uint32_t generation, int count);
+
+  /**
+   * @brief 获取等待指定代数时使用的 futex 位掩码。
+   *
+   * @param generation 等待者已处理的通知代数。
+   * @return 位掩码。
+   */
+  static uint32_t GetWaitBit(uint32_t generation) { return 1U << (generation & 31U); }
+
+  ShmNotifyMode mode_;                         /**< 通知方式。 */
+  std::shared_ptr<SharedMemorySemaphore> sem_; /**< 信号量方式下的命名信号量。 */
+  SharedMemoryNotifyState* state_ = nullptr;   /**< futex 方式下映射的通知状态。 */
+  uint32_t seen_ = 0;                          /**< 本订阅者已处理的通知代数。 */
+  uint32_t decimation_ = 1;                    /**< futex 方式下结束一次等待所需的通知次数。 */
+  std::string name_;                           /**< futex 方式下通知段的名称。 */
+};
+
+}  // namespace ocm
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "common/enum.hpp"
+#include "common/struct_type.hpp"
+
+namespace ocm {
+
+/**
+ * @brief 注册表段的魔数（"OCMREG" + 首个布局版本）。
+ *
+ * 布局变化时只增加 `SHM_REGISTRY_VERSION`，打开旧版本注册表段的进程无需等待魔数即可放弃注册表。
+ */
+inline constexpr uint64_t SHM_REGISTRY_MAGIC = 0x4F434D5245470001ULL;
+
+/**
+ * @brief 注册表段布局版本。
+ */
+inline constexpr uint32_t SHM_REGISTRY_VERSION = 2;
+
+/**
+ * @brief 注册表可记录的话题数量。
+ */
+inline constexpr uint32_t SHM_REGISTRY_CAPACITY = 256;
+
+/**
+ * @brief 注册表中名称字段的长度（含结尾的空字符），超长的名称被截断。
+ */
+inline constexpr size_t SHM_REGISTRY_NAME_SIZE = 64;
+
+/**
+ * @brief 每个话题可记录的发布者和订阅者数量。
+ */
+inline constexpr size_t SHM_REGISTRY_PID_COUNT = 16;
+
+/**
+ * @brief 发布统计写入注册表的最小间隔（纳秒），期间的发布在本进程内累计。
+ */
+inline constexpr uint64_t SHM_REGISTRY_RECORD_INTERVAL = 10000000;
+
+/**
+ * @brief 注册表中的一个话题条目。
+ *
+ * 条目的名称和选项在注册表互斥锁内写入；进程号和发布统计由各进程无锁更新。
+ */
+struct alignas(64) SharedMemoryRegistryEntry {
+  std::atomic<uint32_t> used;                                   /**< 条目是否已被占用。 */
+  uint8_t lock_mode;                                            /**< 锁模式，取值见 `ShmLockMode`。 */
+  uint8_t layout;                                               /**< 数据布局，取值见 `ShmLayout`。 */
+  uint8_t notify_mode;                                          /**< 通知方式，取值见 `ShmNotifyMode`。 */
+  uint8_t reserved;                                             /**< 保留字段。 */
+  uint32_t slot_count;                                          /**< 环形布局下的槽位数量。 */
+  uint64_t capacity;                                            /**< 单条消息的最大字节数，0 表示尚未打开共享内存段。 */
+  int64_t type_hash;                                            /**< 消息类型哈希。 */
+  uint64_t create_time;                                         /**< 条目创建的时刻，`CLOCK_MONOTONIC` 下的纳秒数。 */
+  char topic_name[SHM_REGISTRY_NAME_SIZE];                      /**< 主题名。 */
+  char shm_name[SHM_REGISTRY_NAME_SIZE];                        /**< 共享内存段的名称。 */
+  char type_name[SHM_REGISTRY_NAME_SIZE];                       /**< 消息类型名称。 */
+  std::atomic<int32_t> publisher_pids[SHM_REGISTRY_PID_COUNT];  /**< 发布者进程号，0 表示空闲。 */
+  std::atomic<int32_t> subscriber_pids[SHM_REGISTRY_PID_COUNT]; /**< 订阅者进程号，0 表示空闲。 */
+  std::atomic<uint64_t> publish_count;                          /**< 累计发布的消息数量。 */
+  std::atomic<uint64_t> last_publish_time;                      /**< 最近一次发布的时刻。 */
+  std::atomic<uint64_t> publish_interval;                       /**< 发布间隔的指数移动平均（纳秒）。 */
+  std::atomic<uint32_t> overflow_count;                         /**< 进程号表已满、未能记录进程号的发布者和订阅者数量。 */
+};
+
+/**
+ * @brief 注册表段头部。
+ */
+struct alignas(64) SharedMemoryRegistryHeader {
+  std::atomic<uint64_t> magic; /**< 魔数，创建者初始化完成后最后写入。 */
+  uint32_t version;            /**< 注册表段布局版本。 */
+  uint32_t capacity;           /**< 可记录的话题数量。 */
+  pthread_mutex_t mutex;       /**< 保护条目分配和回收的进程间健壮互斥锁。 */
+};
+
+/**
+ * @brief 共享内存话题注册表。
+ *
+ * `SharedMemoryRegistry` 映射一个固定名称的共享内存段（`openrobot_ocm_registry`），每个话题在其中记录
+ * 主题名、共享内存段名称、消息类型、段选项、发布者和订阅者进程号以及发布统计。
+ * 命令行工具和后加入的进程据此发现话题，无需事先约定名称和选项；长期无人使用的话题可被回收。
+ *
+ * 注册表只用于发现和观测：无法创建或打开注册表段时 `IsAvailable` 返回 `false`，所有记录操作静默跳过，
+ * 不影响话题本身的收发。
+ */
+class SharedMemoryRegistry {
+ public:
+  /**
+   * @brief 删除的拷贝构造函数。
+   */
+  SharedMemoryRegistry(const SharedMemoryRegistry&) = delete;
+
+  /**
+   * @brief 删除的拷贝赋值运算符。
+   */
+  SharedMemoryRegistry& operator=(const SharedMemoryRegistry&) = delete;
+
+  /**
+   * @brief 获取本进程的注册表实例。
+   *
+   * 首次调用时创建或打开注册表段。
+   *
+   * @return 注册表实例的引用。
+   */
+  static SharedMemoryRegistry& getInstance();
+
+  /**
+   * @brief 判断注册表段是否可用。
+   *
+   * @return 注册表段已映射时返回 `true`。
+   */
+  bool IsAvailable() const { return header_ != nullptr; }
+
+  /**
+   * @brief 查找或创建话题条目。
+   *
+   * 以主题名和共享内存段名称为键，已存在时返回原有条目。共用一个共享内存段的多个话题各有一个条目。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param type_name 消息类型名称。
+   * @param type_hash 消息类型哈希。
+   * @param option 共享内存段的选项。
+   * @return 条目索引，注册表不可用或已满时返回 -1。
+   */
+  int Register(const std::string& topic_name, const std::string& shm_name, const std::string& type_name, int64_t type_hash,
+               const SharedMemoryOption& option);
+
+  /**
+   * @brief 更新条目中共享内存段实际使用的选项。
+   *
+   * @param index 条目索引。
+   * @param option 共享内存段实际使用的选项。
+   */
+  void Update(int index, const SharedMemoryOption& option);
+
+  /**
+   * @brief 在条目中登记本进程。
+   *
+   * 优先占用空闲位置，其次占用已退出进程留下的位置。已满时计入条目的 `overflow_count`。
+   *
+   * @param index 条目索引。
+   * @param role 本进程在话题中的角色。
+   * @return 占用的位置，已满时返回 -1。
+   */
+  int AddProcess(int index, ShmRole role);
+
+  /**
+   * @brief 从条目中注销本进程。
+   *
+   * @param index 条目索引。
+   * @param role 本进程在话题中的角色。
+   * @param slot `AddProcess` 返回的位置，为 -1 时从 `overflow_count` 中减去本进程。
+   */
+  void RemoveProcess(int index, ShmRole role, int slot);
+
+  /**
+   * @brief 记录本进程累计的发布。
+   *
+   * @param index 条目索引。
+   * @param timestamp 最近一次发布的时刻，`CLOCK_MONOTONIC` 下的纳秒数。
+   * @param count 自上次记录以来的发布数量。
+   * @param sample 本进程在这段时间内的平均发布间隔（纳秒），为 0 时不更新发布间隔。
+   */
+  void RecordPublish(int index, uint64_t timestamp, uint64_t count, uint64_t sample) {
+    auto& entry = entries_[index];
+    entry.last_publish_time.store(timestamp, std::memory_order_relaxed);
+    entry.publish_count.fetch_add(count, std::memory_order_relaxed);
+    if (sample != 0) {
+      // 发布间隔取 1/8 权重的指数移动平均，多个发布者并发更新时允许丢失个别样本
+      uint64_t interval = entry.publish_interval.load(std::memory_order_relaxed);
+      entry.publish_interval.store(interval == 0 ? sample : interval - interval / 8 + sample / 8, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief 列出所有已注册的话题。
+   *
+   * @return 话题快照列表，注册表不可用时为空。
+   */
+  std::vector<SharedMemoryTopicInfo> List() const;
+
+  /**
+   * @brief 按主题名查找话题。
+   *
+   * @param topic_name 主题名。
+   * @param info 找到时写入话题快照。
+   * @return 找到时返回 `true`。
+   */
+  bool Find(const std::string& topic_name, SharedMemoryTopicInfo* info) const;
+
+  /**
+   * @brief 回收空闲的话题。
+   *
+   * 没有仍在运行的发布者和订阅者、且超过 `idle_nanoseconds` 未发布的话题被回收：
+   * 删除其通知信号量和通知段，以及不再被其他条目使用的共享内存段和段的信号量，并释放条目。
+   * 进程号表溢出过的话题无法确认所有进程都已退出，不被回收。
+   *
+   * @param idle_nanoseconds 空闲时长（纳秒）。
+   * @return 被回收的主题名列表。
+   */
+  std::vector<std::string> Reclaim(uint64_t idle_nanoseconds);
+
+  /**
+   * @brief 删除注册表段。
+   *
+   * 已映射的进程不受影响，之后创建的注册表实例使用新的注册表段。
+   *
+   * @throws std::runtime_error 如果删除失败。
+   */
+  static void Destroy();
+
+ private:
+  /**
+   * @brief 构造函数，创建或打开注册表段。
+   */
+  SharedMemoryRegistry();
+
+  /**
+   * @brief 锁定注册表互斥锁，持锁进程已退出时恢复锁。
+   *
+   * @return 加锁成功时返回 `true`。
+   */
+  bool Lock() const;
+
+  /**
+   * @brief 释放注册表互斥锁。
+   */
+  void UnLock() const;
+
+  /**
+   * @brief 生成条目的快照。
+   *
+   * @param entry 注册表条目。
+   * @return 话题快照。
+   */
+  static SharedMemoryTopicInfo MakeInfo(const SharedMemoryRegistryEntry& entry);
+
+  SharedMemoryRegistryHeader* header_ = nullptr; /**< 映射的注册表段头部，不可用时为空。 */
+  SharedMemoryRegistryEntry* entries_ = nullptr; /**< 映射的注册表条目数组。 */
+};
+
+/**
+ * @brief 话题在注册表中的登记。
+ *
+ * `SharedMemoryRegistration` 由端点持有，登记本进程的发布者或订阅者身份，析构时注销。
+ * 注册表不可用时所有操作均为空操作。
+ */
+class SharedMemoryRegistration {
+ public:
+  /**
+   * @brief 默认构造函数，尚未登记。
+   */
+  SharedMemoryRegistration() = default;
+
+  /**
+   * @brief 析构函数，写入尚未记录的发布并注销本进程。
+   */
+  ~SharedMemoryRegistration();
+
+  /**
+   * @brief 删除的拷贝构造函数。
+   */
+  SharedMemoryRegistration(const SharedMemoryRegistration&) = delete;
+
+  /**
+   * @brief 删除的拷贝赋值运算符。
+   */
+  SharedMemoryRegistration& operator=(const SharedMemoryRegistration&) = delete;
+
+  /**
+   * @brief 登记话题和本进程的角色，同一角色重复调用时不做任何操作。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param type_name 消息类型名称。
+   * @param type_hash 消息类型哈希。
+   * @param option 共享内存段的选项。
+   * @param role 本进程在话题中的角色。
+   * @return 本次调用登记到注册表时返回 `true`。
+   */
+  bool Register(const std::string& topic_name, const std::string& shm_name, const std::string& type_name, int64_t type_hash,
+                const SharedMemoryOption& option, ShmRole role);
+
+  /**
+   * @brief 更新共享内存段实际使用的选项。
+   *
+   * @param option 共享内存段实际使用的选项。
+   */
+  void Update(const SharedMemoryOption& option);
+
+  /**
+   * @brief 判断是否已登记。
+   *
+   * @return 已登记到注册表时返回 `true`。
+   */
+  bool IsRegistered() const { return index_ >= 0; }
+
+  /**
+   * @brief 判断是否已尝试以指定角色登记。
+   *
+   * 只读取本进程内的标志，可在每次发布或订阅前调用，避免重复构造类型名称。
+   *
+   * @param role 本进程在话题中的角色。
+   * @return 已尝试登记时返回 `true`，无论注册表是否可用。
+   */
+  bool IsRegistered(ShmRole role) const { return registered_[static_cast<int>(role)]; }
+
+  /**
+   * @brief 记录一次发布。
+   *
+   * 发布在本进程内累计，距上次写入注册表超过 `SHM_REGISTRY_RECORD_INTERVAL` 时才写入共享的条目，
+   * 高频发布不会每条消息都写注册表的缓存行。
+   *
+   * @param timestamp 发布时刻，`CLOCK_MONOTONIC` 下的纳秒数。
+   */
+  void RecordPublish(uint64_t timestamp) {
+    if (index_ < 0) {
+      return;
+    }
+    ++pending_count_;
+    last_publish_ = timestamp;
+    if (timestamp - record_time_ >= SHM_REGISTRY_RECORD_INTERVAL) {
+      FlushPublish(timestamp);
+    }
+  }
+
+ private:
+  /**
+   * @brief 将本进程累计的发布写入注册表。
+   *
+   * @param timestamp 最近一次发布的时刻。
+   */
+  void FlushPublish(uint64_t timestamp) {
+    uint64_t sample = record_time_ != 0 && timestamp > record_time_ ? std::max<uint64_t>((timestamp - record_time_) / pending_count_, 1) : 0;
+    SharedMemoryRegistry::getInstance().RecordPublish(index_, timestamp, pending_count_, sample);
+    pending_count_ = 0;
+    record_time_ = timestamp;
+  }
+
+  int index_ = -1;              /**< 注册表条目索引，未登记时为 -1。 */
+  int slots_[2] = {-1, -1};     /**< 发布者和订阅者角色占用的位置，未登记时为 -1。 */
+  bool registered_[2] = {};     /**< 发布者和订阅者角色是否已尝试登记。 */
+  bool overflowed_[2] = {};     /**< 发布者和订阅者角色是否因进程号表已满而只计入溢出数量。 */
+  uint64_t pending_count_ = 0;  /**< 尚未写入注册表的发布数量。 */
+  uint64_t record_time_ = 0;    /**< 最近一次写入注册表的时刻。 */
+  uint64_t last_publish_ = 0;   /**< 最近一次发布的时刻。 */
+};
+
+}  // namespace ocm
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "common/enum.hpp"
+#include "ocm/shared_memory_header.hpp"
+
+namespace ocm {
+
+/**
+ * @brief 三缓冲布局的槽位数量。
+ */
+inline constexpr uint32_t SHM_TRIPLE_SLOT_COUNT = 3;
+
+/**
+ * @brief 三缓冲布局下 `triple_latest` 中表示最新值尚未被读者取走的标志位，其余位为缓冲区下标。
+ */
+inline constexpr uint32_t SHM_TRIPLE_DIRTY = 0x80000000U;
+
+/**
+ * @brief 环形缓冲区槽位头部。
+ *
+ * `stamp` 记录槽位中消息的序号：写入序号 `n` 的过程中为 `2n + 1`，写入完成后为 `2n + 2`。
+ * 读者在拷贝前后各读取一次 `stamp`，两次一致且等于期望值时拷贝有效。
+ */
+struct alignas(64) SharedMemoryRingSlot {
+  std::atomic<uint64_t> stamp;       /**< 槽位消息序号戳。 */
+  SharedMemoryMessageHeader message; /**< 槽位中消息的头部。 */
+};
+
+static_assert(sizeof(SharedMemoryRingSlot) % 64 == 0, "SharedMemoryRingSlot must keep the slot payload cache-line aligned");
+
+/**
+ * @brief 共享内存环形缓冲区视图。
+ *
+ * `SharedMemoryRing` 将共享内存段的数据区划分为 `slot_count` 个槽位，每条消息写入一个槽位并带有序号，
+ * 写入序号保存在段头部的 `write_index` 中。每个订阅者持有自己的 `Cursor`，按序读取所有消息；
+ * 只有当发布速度超过订阅者并绕过整个环时才会丢弃最旧的消息，丢弃数量累计在 `Cursor::dropped` 中。
+ *
+ * 三缓冲布局（`ShmLayout::TRIPLE`）复用同一数据区：段中固定 3 个缓冲区，分别归写者、最新值和读者所有，
+ * 下标记录在段头部。写者写完自己的缓冲区后以一次原子交换把它设为最新值并置未读标志，换回上一个最新值缓冲区；
+ * 读者发现未读标志时以一次原子交换换入最新值，并把自己读完的缓冲区交还。双方都只访问自己独占的缓冲区，
+ * 不加锁、不重试，也从不等待对方。三缓冲只支持一个写者和一个读者，首次写入或读取时在段头部登记本视图的标识
+ * （进程号与进程内的视图序号），已有其他视图登记且其进程存活时抛出异常，同一进程中的第二个读者或写者同样被拒绝。
+ *
+ * 环形布局的写者之间需要由调用者互斥（例如持有共享内存段的写锁），读者不加锁。
+ */
+class SharedMemoryRing {
+ public:
+  /**
+   * @brief 订阅者的读取游标。
+   */
+  struct Cursor {
+    uint64_t next = 0;     /**< 下一条待读取消息的序号。 */
+    uint64_t dropped = 0;  /**< 因缓冲区溢出而丢弃的消息总数。 */
+    bool attached = false; /**< 游标是否已与写入位置同步。 */
+  };
+
+  /**
+   * @brief 在共享内存数据区上构造环形缓冲区视图。
+   *
+   * @param header 共享内存段头部，提供槽位数量和写入序号。
+   * @param region 数据区起始地址。
+   * @param region_size 数据区大小（字节）。
+   *
+   * @throws std::runtime_error 如果数据区不足以容纳所有槽位。
+   */
+  SharedMemoryRing(SharedMemoryHeader* header, uint8_t* region, size_t region_size)
+      : header_(header),
+        region_(region),
+        slot_count_(header->slot_count),
+        triple_(header->layout == static_cast<uint8_t>(ShmLayout::TRIPLE)),
+        view_id_(++next_view_id_) {
+    if (slot_count_ == 0 || region_size / slot_count_ <= sizeof(SharedMemoryRingSlot)) {
+      throw std::runtime_error("[SharedMemoryRing] Region of " + std::to_string(region_size) + " bytes is too small for " +
+                               std::to_string(slot_count_) + " slots");
+    }
+    stride_ = region_size / slot_count_;
+    slot_capacity_ = stride_ - sizeof(SharedMemoryRingSlot);
+  }
+
+  /**
+   * @brief 注销本视图在三缓冲布局中登记的写者和读者。
+   */
+  ~SharedMemoryRing() {
+    Release(header_->triple_writer, writer_token_);
+    Release(header_->triple_reader, reader_token_);
+  }
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+  /**
+   * @brief 判断是否为三缓冲布局。
+   *
+   * @return 三缓冲布局时返回 `true`，此时写入无需调用者互斥。
+   */
+  bool IsTriple() const { return triple_; }
+
+  /**
+   * @brief 计算容纳指定槽位的数据区大小。
+   *
+   * @param slot_count 槽位数量。
+   * @param slot_capacity 每个槽位可容纳的消息字节数。
+   * @return 数据区大小（字节），每个槽位按缓存行对齐。
+   */
+  static size_t RegionSize(uint32_t slot_count, size_t slot_capacity) {
+    size_t stride = (sizeof(SharedMemoryRingSlot) + slot_capacity + 63) & ~static_cast<size_t>(63);
+    return stride * slot_count;
+  }
+
+  /**
+   * @brief 获取每个槽位可容纳的消息字节数。
+   *
+   * @return 槽位容量（字节）。
+   */
+  size_t GetSlotCapacity() const { return slot_capacity_; }
+
+  /**
+   * @brief 写入一条消息。
+   *
+   * 环形布局下调用者需保证写者之间互斥。
+   *
+   * @tparam Writer 写入函数类型，签名为 `void(uint8_t* dst)`。
+   * @param size 消息字节数。
+   * @param writer 将消息写入 `dst` 的函数。
+   *
+   * @throws std::runtime_error 如果消息超过槽位容量。
+   */
+  template <typename Writer>
+  void Write(size_t size, Writer&& writer) {
+    writer(Loan(size));
+    SharedMemoryMessageHeader message{};
+    message.payload_size = static_cast<uint32_t>(size);
+    Commit(message);
+  }
+
+  /**
+   * @brief 借出下一个槽位的消息数据区，供调用者直接写入。
+   *
+   * 槽位在 `Commit` 之前对读者不可见。环形布局下调用者需保证写者之间互斥，并在写入后调用 `Commit`；
+   * 三缓冲布局下借出写者独占的缓冲区，无需互斥。
+   *
+   * @param size 消息字节数。
+   * @return 指向槽位消息数据区的指针。
+   *
+   * @throws std::runtime_error 如果消息超过槽位容量，或三缓冲布局已有其他写者。
+   */
+  uint8_t* Loan(size_t size) {
+    if (size > slot_capacity_) {
+      throw std::runtime_error("[SharedMemoryRing] Message of " + std::to_string(size) + " bytes exceeds slot capacity " +
+                               std::to_string(slot_capacity_));
+    }
+    if (triple_) {
+      Claim(header_->triple_writer, writer_token_, "writer");
+      return Payload(Slot(header_->triple_back));
+    }
+    uint64_t index = header_->write_index.load(std::memory_order_relaxed);
+    SharedMemoryRingSlot* slot = Slot(index);
+    slot->stamp.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return Payload(slot);
+  }
+
+  /**
+   * @brief 提交 `Loan` 借出的槽位，使消息对读者可见。
+   *
+   * @param message 消息头部，其中的序号由环形缓冲区按写入序号填写。
+   */
+  void Commit(const SharedMemoryMessageHeader& message) {
+    uint64_t index = header_->write_index.load(std::memory_order_relaxed);
+    if (triple_) {
+      SharedMemoryRingSlot* slot = Slot(header_->triple_back);
+      slot->message = message;
+      slot->message.seq = index + 1;
+      header_->write_index.store(index + 1, std::memory_order_release);
+      // 发布写好的缓冲区并换回上一个最新值缓冲区，读者交还的缓冲区也经由此处回到写者
+      uint32_t latest = header_->triple_latest.exchange(header_->triple_back | SHM_TRIPLE_DIRTY, std::memory_order_acq_rel);
+      header_->triple_back = latest & ~SHM_TRIPLE_DIRTY;
+      return;
+    }
+    SharedMemoryRingSlot* slot = Slot(index);
+    slot->message = message;
+    slot->message.seq = index + 1;
+    slot->stamp.store(2 * index + 2, std::memory_order_release);
+    header_->write_index.store(index + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief 判断游标处是否有未读消息。
+   *
+   * @param cursor 订阅者游标。
+   * @return 有未读消息时返回 `true`。
+   */
+  bool HasUnread(Cursor& cursor) {
+    Attach(cursor);
+    if (triple_) {
+      Claim(header_->triple_reader, reader_token_, "reader");
+      return (header_->triple_latest.load(std::memory_order_acquire) & SHM_TRIPLE_DIRTY) || Slot(header_->triple_front)->message.seq > cursor.next;
+    }
+    return cursor.next < header_->write_index.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 将游标前移到指定序号，跳过其间的未读消息。
+   *
+   * 跳过的消息不计入丢弃数量。游标最多前移到最新一条消息，不会越过写入位置。
+   *
+   * @param cursor 订阅者游标。
+   * @param index 下一条待读取消息的序号。
+   */
+  void Skip(Cursor& cursor, uint64_t index) const {
+    Attach(cursor);
+    uint64_t head = header_->write_index.load(std::memory_order_acquire);
+    if (head > 0) {
+      cursor.next = std::max(cursor.next, std::min(index, head - 1));
+    }
+  }
+
+  /**
+   * @brief 读取游标处的下一条消息。
+   *
+   * 若游标已被写者绕过，则跳到仍然有效的最旧消息，并累计丢弃数量；`reader` 可能因读取过程中被覆盖而被多次调用，只应拷贝数据。
+   * 三缓冲布局下换入最新消息后在读者独占的缓冲区上只调用一次 `reader`，跳过的旧消息不计为丢弃。
+   *
+   * @tparam Reader 读取函数类型，签名为 `void(const SharedMemoryMessageHeader& message, const uint8_t* src, size_t size)`。
+   * @param cursor 订阅者游标。
+   * @param reader 拷贝消息的函数。
+   * @return 读取到消息时返回 `true`，没有未读消息时返回 `false`。
+   *
+   * @throws std::runtime_error 如果三缓冲布局已有其他读者进程。
+   */
+  template <typename Reader>
+  bool Read(Cursor& cursor, Reader&& reader) {
+    Attach(cursor);
+    if (triple_) {
+      return ReadLatest(cursor, reader);
+    }
+    while (true) {
+      uint64_t head = header_->write_index.load(std::memory_order_acquire);
+      if (cursor.next >= head) {
+        return false;
+      }
+      if (head - cursor.next > slot_count_) {
+        cursor.dropped += head - slot_count_ - cursor.next;
+        cursor.next = head - slot_count_;
+      }
+      const SharedMemoryRingSlot* slot = Slot(cursor.next);
+      uint64_t expected = 2 * cursor.next + 2;
+      uint64_t stamp = slot->stamp.load(std::memory_order_acquire);
+      if (stamp == expected) {
+        SharedMemoryMessageHeader message = slot->message;
+        reader(message, Payload(slot), std::min<size_t>(message.payload_size, slot_capacity_));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->stamp.load(std::memory_order_relaxed) == expected) {
+          ++cursor.next;
+          return true;
+        }
+      }
+      // 槽位已被更新的消息覆盖，计入丢弃并继续读取下一条
+      if (stamp > expected) {
+        cursor.dropped += 1;
+        cursor.next += 1;
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief 三缓冲布局下读取最新消息。
+   *
+   * 有未读标志时把读者独占的缓冲区与最新值交换，随后读取读者缓冲区中游标之后的消息。
+   *
+   * @param cursor 订阅者游标，`next` 为已读取的最新消息序号。
+   * @param reader 拷贝消息的函数。
+   * @return 读取到消息时返回 `true`。
+   */
+  template <typename Reader>
+  bool ReadLatest(Cursor& cursor, Reader& reader) {
+    Claim(header_->triple_reader, reader_token_, "reader");
+    if (header_->triple_latest.load(std::memory_order_relaxed) & SHM_TRIPLE_DIRTY) {
+      header_->triple_front = header_->triple_latest.exchange(header_->triple_front, std::memory_order_acq_rel) & ~SHM_TRIPLE_DIRTY;
+    }
+    const SharedMemoryRingSlot* slot = Slot(header_->triple_front);
+    if (slot->message.seq <= cursor.next) {
+      return false;
+    }
+    SharedMemoryMessageHeader message = slot->message;
+    cursor.next = message.seq;
+    reader(message, Payload(slot), std::min<size_t>(message.payload_size, slot_capacity_));
+    return true;
+  }
+
+  /**
+   * @brief 在三缓冲布局中登记本视图为写者或读者。
+   *
+   * 登记标识的高 32 位为进程号、低 32 位为进程内的视图序号，同一进程中的不同视图也互相排斥。
+   * 已登记视图所在的进程不存在时接管登记。
+   *
+   * @param owner 段头部中的写者或读者登记标识。
+   * @param token 本视图的登记标识，未登记时为 0，登记成功后写入。
+   * @param role 角色名称，用于异常信息。
+   *
+   * @throws std::runtime_error 如果已有其他视图登记且其进程存活。
+   */
+  void Claim(std::atomic<uint64_t>& owner, uint64_t& token, const char* role) const {
+    if (token != 0) {
+      return;
+    }
+    const int32_t pid = getpid();
+    const uint64_t claim = static_cast<uint64_t>(pid) << 32 | view_id_;
+    uint64_t current = owner.load(std::memory_order_acquire);
+    while (true) {
+      const int32_t owner_pid = static_cast<int32_t>(current >> 32);
+      if (current != 0 && owner_pid == pid) {
+        throw std::runtime_error(std::string("[SharedMemoryRing] Triple buffer already has a ") + role + " in this process");
+      }
+      if (current != 0 && (kill(owner_pid, 0) == 0 || errno != ESRCH)) {
+        throw std::runtime_error(std::string("[SharedMemoryRing] Triple buffer already has a ") + role + " process " + std::to_string(owner_pid));
+      }
+      if (owner.compare_exchange_weak(current, claim, std::memory_order_acq_rel)) {
+        break;
+      }
+    }
+    token = claim;
+  }
+
+  /**
+   * @brief 注销本视图在三缓冲布局中的登记，其他视图的登记不受影响。
+   *
+   * @param owner 段头部中的写者或读者登记标识。
+   * @param token 本视图的登记标识，未登记时为 0。
+   */
+  static void Release(std::atomic<uint64_t>& owner, uint64_t token) {
+    if (token != 0) {
+      owner.compare_exchange_strong(token, 0, std::memory_order_acq_rel);
+    }
+  }
+
+  /**
+   * @brief 首次使用时将游标同步到最新一条消息。
+   *
+   * 新订阅者从当前最新的消息开始读取，与单槽位布局中读取最新值的语义一致。
+   *
+   * @param cursor 订阅者游标。
+   */
+  void Attach(Cursor& cursor) const {
+    if (!cursor.attached) {
+      uint64_t head = header_->write_index.load(std::memory_order_acquire);
+      cursor.next = head > 0 ? head - 1 : 0;
+      cursor.attached = true;
+    }
+  }
+
+  /**
+   * @brief 获取序号对应的槽位。
+   *
+   * @param index 消息序号。
+   * @return 指向槽位头部的指针。
+   */
+  SharedMemoryRingSlot* Slot(uint64_t index) const { return reinterpret_cast<SharedMemoryRingSlot*>(region_ + (index % slot_count_) * stride_); }
+
+  /**
+   * @brief 获取槽位的消息数据区。
+   *
+   * @param slot 槽位头部。
+   * @return 指向槽位消息数据的指针。
+   */
+  static uint8_t* Payload(const SharedMemoryRingSlot* slot) {
+    return reinterpret_cast<uint8_t*>(const_cast<SharedMemoryRingSlot*>(slot)) + sizeof(SharedMemoryRingSlot);
+  }
+
+  SharedMemoryHeader* header_;  /**< 共享内存段头部。 */
+  uint8_t* region_;             /**< 数据区起始地址。 */
+  uint32_t slot_count_;         /**< 槽位数量。 */
+  size_t stride_;               /**< 相邻槽位的间距（字节）。 */
+  size_t slot_capacity_;        /**< 每个槽位可容纳的消息字节数。 */
+  bool triple_;                 /**< 是否为三缓冲布局。 */
+  uint32_t view_id_;            /**< 本视图在进程内的序号，构成三缓冲登记标识的低 32 位。 */
+  uint64_t writer_token_ = 0;   /**< 三缓冲布局下写者的登记标识，0 表示未登记。 */
+  uint64_t reader_token_ = 0;   /**< 三缓冲布局下读者的登记标识，0 表示未登记。 */
+
+  static inline std::atomic<uint32_t> next_view_id_{0}; /**< 进程内下一个视图的序号。 */
+};
+
+}  // namespace ocm
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+
+namespace ocm {
+/**
+ * @brief 获取消息对象。
+ *
+ * 发布接口既接受消息本身，也接受指向消息的指针或智能指针。
+ *
+ * @tparam MessageType 消息或指向消息的指针类型。
+ * @param msg 消息或指向消息的指针。
+ * @return 消息对象的引用。
+ */
+template <class MessageType>
+const auto& DerefMessage(const MessageType& msg) {
+  if constexpr (requires { *msg; }) {
+    return *msg;
+  } else {
+    return msg;
+  }
+}
+
+/**
+ * @brief 计算类型名的 FNV-1a 哈希。
+ *
+ * @param type_name 类型名。
+ * @param size 参与哈希的类型大小，为 0 时不参与。
+ * @return 类型哈希，不为 0。
+ */
+inline int64_t GetTypeNameHash(const char* type_name, size_t size = 0) {
+  uint64_t value = 14695981039346656037ULL;
+  for (const char* c = type_name; *c != '\0'; ++c) {
+    value = (value ^ static_cast<uint8_t>(*c)) * 1099511628211ULL;
+  }
+  if (size != 0) {
+    value = (value ^ size) * 1099511628211ULL;
+  }
+  return static_cast<int64_t>(value | 1);
+}
+
+/**
+ * @brief 计算定长消息类型的类型哈希。
+ *
+ * 对类型名和大小做 FNV-1a 哈希，用于在消息头部中区分不同的定长消息类型。
+ *
+ * @tparam MessageType 消息类型。
+ * @return 类型哈希，不为 0。
+ */
+template <class MessageType>
+int64_t GetPodTypeHash() {
+  static const int64_t hash = GetTypeNameHash(typeid(MessageType).name(), sizeof(MessageType));
+  return hash;
+}
+
+/**
+ * @brief LCM 消息的序列化策略。
+ *
+ * 序列化策略是 `SharedMemoryTopic` 的编译期参数，以消息类型实例化后提供以下静态函数：
+ * - `int64_t GetTypeHash()`：写入消息头部的类型哈希，0 表示不检查；
+ * - `std::string GetTypeName()`：登记到话题注册表的类型名称；
+ * - `size_t GetSize(const MessageType& msg)`：序列化后的字节数；
+ * - `void Serialize(const MessageType& msg, uint8_t* dst, size_t size)`：直接序列化到共享内存中的 `dst`；
+ * - `void Deserialize(const uint8_t* data, size_t size, MessageType& msg)`：从快照反序列化到 `msg`，复用其容量。
+ *
+ * 自定义序列化方式只需按同样的接口提供一个类模板。
+ *
+ * @tparam MessageType 消息类型。必须支持 `encode`、`decode`、`getEncodedSize`、`getHash` 和 `getTypeName` 方法。
+ */
+template <class MessageType>
+struct LcmSerializer {
+  static int64_t GetTypeHash() { return MessageType::getHash(); }
+
+  static std::string GetTypeName() { return MessageType::getTypeName(); }
+
+  static size_t GetSize(const MessageType& msg) { return static_cast<size_t>(msg.getEncodedSize()); }
+
+  static void Serialize(const MessageType& msg, uint8_t* dst, size_t size) { msg.encode(dst, 0, static_cast<int>(size)); }
+
+  static void Deserialize(const uint8_t* data, size_t size, MessageType& msg) { msg.decode(data, 0, static_cast<int>(size)); }
+};
+
+/**
+ * @brief 定长消息的序列化策略，按内存布局直接拷贝。
+ *
+ * 接口见 `LcmSerializer`。
+ *
+ * @tparam MessageType 消息类型。必须可平凡复制。
+ */
+template <class MessageType>
+struct PodSerializer {
+  static_assert(std::is_trivially_copyable_v<MessageType>, "PodSerializer requires a trivially copyable message type");
+
+  static int64_t GetTypeHash() { return GetPodTypeHash<MessageType>(); }
+
+  static std::string GetTypeName() { return typeid(MessageType).name(); }
+
+  static size_t GetSize(const MessageType&) { return sizeof(MessageType); }
+
+  static void Serialize(const MessageType& msg, uint8_t* dst, size_t) { memcpy(dst, &msg, sizeof(MessageType)); }
+
+  static void Deserialize(const uint8_t* data, size_t size, MessageType& msg) { memcpy(&msg, data, std::min(size, sizeof(MessageType))); }
+};
+
+}  // namespace ocm
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "common/struct_type.hpp"
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+
+namespace ocm {
+/**
+ * @class SharedMemoryTap
+ * @brief 话题的旁路读者，读取所有新消息而不影响应用的订阅者。
+ *
+ * 供录制、转发等不知道消息类型的工具使用，按通知方式选择读取方式：
+ * - futex 通知的话题由调用者将 `GetNotifier` 加入等待集，就绪后调用 `ReadReady`。futex 通知按订阅者各自计数，
+ *   取走通知不影响其他订阅者。不要把端点交给等待集，检查三缓冲布局的未读消息会登记为读者。
+ * - 信号量通知的话题由调用者定期调用 `Poll`。命名信号量由所有订阅者共享，取走通知会使应用的订阅者错过消息，
+ *   因此轮询时不消耗通知：带头部的段按消息序号判断新消息，裸数据段没有序号，按内容变化判断新消息，
+ *   连续发布的相同内容只读到一次。
+ *
+ * 三缓冲布局只允许一个读者，共享内存段打开后若为三缓冲布局则不再读取，`IsExcluded` 返回 `true`。
+ */
+class SharedMemoryTap {
+ public:
+  /**
+   * @brief 构造旁路读者，并在话题注册表中登记为订阅者。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param notify_mode 话题的通知方式，需要与发布者一致。
+   *
+   * @throws std::runtime_error 如果创建或访问通知器失败。
+   */
+  SharedMemoryTap(const std::string& topic_name, const std::string& shm_name, ShmNotifyMode notify_mode)
+      : notifier_(topic_name, notify_mode), endpoint_(shm_name), polled_(notify_mode == ShmNotifyMode::SEMAPHORE) {
+    endpoint_.Advertise(topic_name, "", ShmRole::SUBSCRIBER);
+  }
+
+  /**
+   * @brief 判断是否按轮询方式读取。
+   *
+   * @return 信号量通知的话题返回 `true`，应定期调用 `Poll`；否则应在等待集就绪后调用 `ReadReady`。
+   */
+  bool IsPolled() const { return polled_; }
+
+  /**
+   * @brief 判断话题是否因三缓冲布局而不读取。
+   *
+   * @return 共享内存段已打开且为三缓冲布局时返回 `true`。
+   */
+  bool IsExcluded() const { return excluded_; }
+
+  /**
+   * @brief 获取话题的通知器，用于加入等待集。
+   */
+  SharedMemoryNotifier& GetNotifier() { return notifier_; }
+
+  /**
+   * @brief 获取共享内存段的端点，用于在读取函数中获取消息头部和统计。
+   */
+  SharedMemoryEndpoint& GetEndpoint() { return endpoint_; }
+
+  /**
+   * @brief 等待集就绪后读取 futex 通知话题的所有新消息。
+   *
+   * 不读取的三缓冲话题只取走通知，避免等待集反复就绪。
+   *
+   * @tparam Reader 读取函数类型，签名为 `void(const uint8_t*, size_t)`。
+   * @param reader 读取函数，每条新消息调用一次。
+   * @return 读取的消息数量。
+   *
+   * @throws std::runtime_error 如果访问共享内存失败。
+   */
+  template <typename Reader>
+  size_t ReadReady(Reader&& reader) {
+    if (excluded_) {
+      notifier_.TryWait();
+      return 0;
+    }
+    return endpoint_.TryWait(notifier_) ? Read(reader) : 0;
+  }
+
+  /**
+   * @brief 不消耗通知地读取信号量通知话题的新消息。
+   *
+   * 共享内存段由发布者创建后才打开，旁路读者不创建尚不存在的段。
+   *
+   * @tparam Reader 读取函数类型，签名为 `void(const uint8_t*, size_t)`。
+   * @param reader 读取函数，每条新消息调用一次。
+   * @return 读取的消息数量。
+   *
+   * @throws std::runtime_error 如果访问共享内存失败。
+   */
+  template <typename Reader>
+  size_t Poll(Reader&& reader) {
+    return endpoint_.OpenExisting() ? Read(reader) : 0;
+  }
+
+ private:
+  /**
+   * @brief 读取所有新消息，首次读取前检查布局。
+   */
+  template <typename Reader>
+  size_t Read(Reader& reader) {
+    if (!checked_) {
+      checked_ = true;
+      excluded_ = endpoint_.IsTriple();
+    }
+    if (excluded_) {
+      return 0;
+    }
+    size_t count = 0;
+    endpoint_.Snapshot([&](const uint8_t* data, size_t size) {
+      if (polled_ && !endpoint_.HasMessageHeader()) {
+        // 裸数据段每次轮询都会读到当前内容，内容变化才是新消息
+        if (last_payload_.size() == size && memcmp(last_payload_.data(), data, size) == 0) {
+          return;
+        }
+        last_payload_.assign(data, data + size);
+      }
+      ++count;
+      reader(data, size);
+    });
+    return count;
+  }
+
+  SharedMemoryNotifier notifier_;     /**< 话题的通知器。 */
+  SharedMemoryEndpoint endpoint_;     /**< 共享内存段的端点。 */
+  bool polled_;                       /**< 是否为信号量通知的话题，按轮询方式读取。 */
+  bool checked_ = false;              /**< 是否已在打开共享内存段后检查过布局。 */
+  bool excluded_ = false;             /**< 是否为三缓冲布局而不读取。 */
+  std::vector<uint8_t> last_payload_; /**< 轮询的裸数据段最近读取的内容。 */
+};
+
+}  // namespace ocm
@@ -0,0 +1,691 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ocm/shared_memory_batch.hpp"
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "ocm/shared_memory_serializer.hpp"
+
+namespace ocm {
+/**
+ * @brief 共享内存主题管理器。
+ *
+ * `SharedMemoryTopic` 类简化了使用共享内存发布和订阅主题的过程。
+ * 它管理多个共享内存段和通知器，允许不同主题之间高效的进程间通信。
+ * 消息的序列化方式由编译期的序列化策略决定，发布时直接序列化到共享内存中，传输部分与序列化方式无关。
+ * `SharedMemoryTopicLcm`、`SharedMemoryTopicRos2` 分别是 LCM 和 ROS 2 消息的实例。
+ *
+ * 注意：默认的 `ShmNotifyMode::SEMAPHORE` 通知方式下，每次发布只唤醒一个阻塞等待的订阅者，同一话题的多个订阅者
+ * 会互相抢夺通知；一个话题有多个订阅进程时，发布者和所有订阅者都应通过 `SetOption` 选择 `ShmNotifyMode::FUTEX`，
+ * 每次发布唤醒所有订阅者。
+ *
+ * @tparam SerializerPolicy 序列化策略类模板，接口见 `LcmSerializer`。
+ */
+template <template <class> class SerializerPolicy>
+class SharedMemoryTopic {
+ public:
+  /**
+   * @brief 默认构造函数。
+   *
+   * 初始化 `SharedMemoryTopic` 实例。
+   */
+  SharedMemoryTopic() = default;
+
+  /**
+   * @brief 删除的拷贝构造函数。
+   *
+   * 防止复制 `SharedMemoryTopic` 实例以保持唯一所有权语义。
+   */
+  SharedMemoryTopic(const SharedMemoryTopic&) = delete;
+
+  /**
+   * @brief 删除的拷贝赋值运算符。
+   *
+   * 防止将一个 `SharedMemoryTopic` 赋值给另一个以保持唯一所有权语义。
+   */
+  SharedMemoryTopic& operator=(const SharedMemoryTopic&) = delete;
+
+  /**
+   * @brief 删除的移动构造函数。
+   *
+   * 防止移动 `SharedMemoryTopic` 实例以保持唯一所有权语义。
+   */
+  SharedMemoryTopic(SharedMemoryTopic&&) = delete;
+
+  /**
+   * @brief 删除的移动赋值运算符。
+   *
+   * 防止移动赋值 `SharedMemoryTopic` 实例以保持唯一所有权语义。
+   */
+  SharedMemoryTopic& operator=(SharedMemoryTopic&&) = delete;
+
+  /**
+   * @brief 析构函数。
+   *
+   * 默认析构函数确保共享内存主题的正确清理。
+   */
+  ~SharedMemoryTopic() = default;
+
+  /**
+   * @brief 设置共享内存段的创建选项。
+   *
+   * 需在首次发布或订阅 `shm_name` 之前调用，锁模式和布局仅在本实例创建该共享内存段时生效。
+   * 订阅者打开已存在的段时会按段头部自动选择读取方式，但通知方式需要与发布者设置一致。
+   * 默认的信号量通知方式每次发布只唤醒一个订阅者，有多个订阅者时应选择 `ShmNotifyMode::FUTEX`。
+   *
+   * @param shm_name 共享内存段的名称。
+   * @param option 共享内存段的创建选项。
+   */
+  void SetOption(const std::string& shm_name, const SharedMemoryOption& option) { option_map_[shm_name] = option; }
+
+  /**
+   * @brief 获取环形布局下本实例订阅主题时因缓冲区溢出而丢弃的消息数量。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @return 累计丢弃的消息数量，非环形布局或尚未订阅时返回 0。
+   */
+  uint64_t GetDroppedCount(const std::string& topic_name, const std::string& shm_name) const {
+    auto* endpoint = FindEndpoint(topic_name, shm_name);
+    return endpoint ? endpoint->GetDroppedCount() : 0;
+  }
+
+  /**
+   * @brief 获取本实例读取时持有共享内存段锁的时间统计。
+   *
+   * 需通过 `SetOption` 开启 `lock_stats`。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @return 读取时的持锁时间统计，尚未订阅时各字段为 0。
+   */
+  SharedMemoryLockStats GetReadLockStats(const std::string& topic_name, const std::string& shm_name) const {
+    auto* endpoint = FindEndpoint(topic_name, shm_name);
+    return endpoint ? endpoint->GetReadLockStats() : SharedMemoryLockStats{};
+  }
+
+  /**
+   * @brief 获取本实例写入时持有共享内存段锁的时间统计。
+   *
+   * 需通过 `SetOption` 开启 `lock_stats`。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @return 写入时的持锁时间统计，尚未发布时各字段为 0。
+   */
+  SharedMemoryLockStats GetWriteLockStats(const std::string& topic_name, const std::string& shm_name) const {
+    auto* endpoint = FindEndpoint(topic_name, shm_name);
+    return endpoint ? endpoint->GetWriteLockStats() : SharedMemoryLockStats{};
+  }
+
+  /**
+   * @brief 发布单个消息到指定主题。
+   *
+   * 将消息写入与 `shm_name` 关联的共享内存段，并发送与 `topic_name` 关联的通知器以通知订阅者。
+   *
+   * @tparam MessageType 发布消息的类型，可以是消息或指向消息的指针。
+   * @param topic_name 发布到的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param msg 要发布的消息或指向它的指针。
+   *
+   * @throws std::runtime_error 如果写入共享内存或发送通知失败。
+   */
+  template <class MessageType>
+  void Publish(const std::string& topic_name, const std::string& shm_name, const MessageType& msg) {
+    WriteDataToSHM(topic_name, shm_name, msg);
+    GetNotifier(topic_name, shm_name).Notify();
+  }
+
+  /**
+   * @brief 发布多个消息到多个指定主题。
+   *
+   * 将消息列表作为一条批量消息写入与 `shm_name` 关联的共享内存段：只获取一次写锁，每条消息直接编码到共享内存中，
+   * 随后对提供的每个 `topic_name` 只发送一次通知。批量消息的帧格式见 `EncodeBatch`，
+   * 其类型哈希与单条消息不同，订阅者需使用 `SubscribeList` 系列接口读取。
+   * 共享内存段默认按首条批量消息的大小创建，批量长度可变时应通过 `SetOption` 声明 `capacity`。
+   *
+   * @tparam MessageType 发布消息的类型，可以是消息或指向消息的指针。
+   * @param topic_names 发布消息的主题名称向量。
+   * @param shm_name 共享内存段的名称。
+   * @param msgs 要发布的消息向量。
+   *
+   * @throws std::runtime_error 如果写入共享内存或发送任何通知失败。
+   */
+  template <class MessageType>
+  void PublishList(const std::vector<std::string>& topic_names, const std::string& shm_name, const std::vector<MessageType>& msgs) {
+    using Message = std::remove_cvref_t<decltype(DerefMessage(std::declval<const MessageType&>()))>;
+    auto& endpoint = GetAdvertisedEndpoint<Message>(topic_names.empty() ? shm_name : topic_names.front(), shm_name, ShmRole::PUBLISHER, true);
+    size_t size = GetBatchEncodedSize<SerializerPolicy>(msgs, batch_sizes_);
+    endpoint.Write(size, [&](uint8_t* dst) { EncodeBatch<SerializerPolicy>(dst, msgs, batch_sizes_); });
+    for (const auto& topic : topic_names) {
+      GetNotifier(topic, shm_name).Notify();
+    }
+  }
+
+  /**
+   * @brief 订阅指定主题并使用回调处理接收的消息。
+   *
+   * 等待与 `topic_name` 关联的通知器，读取共享内存段 `shm_name` 中的消息，
+   * 解码它，并使用解码后的消息调用提供的 `callback`。
+   * 环形布局下依次对所有未读消息调用 `callback`，已有未读消息时不等待通知。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param callback 处理接收消息的回调函数。
+   *
+   * @throws std::runtime_error 如果访问共享内存或通知器失败。
+   */
+  template <class MessageType, typename Callback>
+  void Subscribe(const std::string& topic_name, const std::string& shm_name, Callback callback) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER);
+    MessageType msg;
+    do {
+      endpoint.Wait(notifier);
+    } while (endpoint.Read(MakeDecoder(msg), [&] { callback(msg); }) == 0);
+  }
+
+  /**
+   * @brief 尝试订阅指定主题而不阻塞。
+   *
+   * 检查与 `topic_name` 关联的通知器。如果有未处理的通知，则从共享内存段 `shm_name` 中读取并解码消息，
+   * 并使用解码后的消息调用提供的 `callback`。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param callback 处理接收消息的回调函数。
+   */
+  template <class MessageType, typename Callback>
+  void SubscribeNoWait(const std::string& topic_name, const std::string& shm_name, Callback callback) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER);
+    if (endpoint.TryWait(notifier)) {
+      MessageType msg;
+      endpoint.Read(MakeDecoder(msg), [&] { callback(msg); });
+    }
+  }
+
+  /**
+   * @brief 订阅指定主题并设置超时时间。
+   *
+   * 等待与 `topic_name` 关联的通知器，并在超时时间内读取共享内存段 `shm_name` 中的消息，
+   * 解码它，并使用解码后的消息调用提供的 `callback`。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param callback 处理接收消息的回调函数。
+   * @param timeout 等待的超时时间（毫秒）。
+   */
+  template <class MessageType, typename Callback>
+  void SubscribeTimeout(const std::string& topic_name, const std::string& shm_name, Callback callback, int timeout) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER);
+    if (endpoint.WaitTimeout(notifier, timeout)) {
+      MessageType msg;
+      endpoint.Read(MakeDecoder(msg), [&] { callback(msg); });
+    }
+  }
+
+  /**
+   * @brief 订阅指定主题并将消息解码到调用者持有的对象中。
+   *
+   * 与回调版本相同地等待并读取消息，但解码目标为 `msg`：反复使用同一个对象时复用其中容器的容量，
+   * 稳态接收不进行内存分配。环形布局下依次解码所有未读消息，返回时 `msg` 为其中最新的一条。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param msg 解码目标，返回时为收到的消息。
+   *
+   * @throws std::runtime_error 如果访问共享内存或通知器失败。
+   */
+  template <class MessageType>
+  void Subscribe(const std::string& topic_name, const std::string& shm_name, MessageType& msg) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER);
+    do {
+      endpoint.Wait(notifier);
+    } while (endpoint.Read(MakeDecoder(msg), [] {}) == 0);
+  }
+
+  /**
+   * @brief 不阻塞地尝试将消息解码到调用者持有的对象中。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param msg 解码目标，收到消息时更新，否则保持不变。
+   * @return 收到新消息时返回 `true`。
+   */
+  template <class MessageType>
+  bool SubscribeNoWait(const std::string& topic_name, const std::string& shm_name, MessageType& msg) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER);
+    return endpoint.TryWait(notifier) && endpoint.Read(MakeDecoder(msg), [] {}) > 0;
+  }
+
+  /**
+   * @brief 在超时时间内等待消息并解码到调用者持有的对象中。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param msg 解码目标，收到消息时更新，否则保持不变。
+   * @param timeout 等待的超时时间（毫秒）。
+   * @return 收到新消息时返回 `true`，超时时返回 `false`。
+   */
+  template <class MessageType>
+  bool SubscribeTimeout(const std::string& topic_name, const std::string& shm_name, MessageType& msg, int timeout) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER);
+    return endpoint.WaitTimeout(notifier, timeout) && endpoint.Read(MakeDecoder(msg), [] {}) > 0;
+  }
+
+  /**
+   * @brief 订阅 `PublishList` 发布的批量消息。
+   *
+   * 等待与 `topic_name` 关联的通知器，将共享内存段 `shm_name` 中的批量消息整体拷贝一次后释放锁，
+   * 再依次解码其中的每条消息并调用 `callback`，解码期间不阻塞发布者。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param callback 处理接收消息的回调函数，批量消息中的每条消息调用一次。
+   *
+   * @throws std::runtime_error 如果访问共享内存或通知器失败，或批量消息格式错误。
+   */
+  template <class MessageType, typename Callback>
+  void SubscribeList(const std::string& topic_name, const std::string& shm_name, Callback callback) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER, true);
+    MessageType msg;
+    do {
+      endpoint.Wait(notifier);
+    } while (endpoint.Snapshot(MakeBatchReader(msg, callback)) == 0);
+  }
+
+  /**
+   * @brief 尝试订阅 `PublishList` 发布的批量消息而不阻塞。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param callback 处理接收消息的回调函数，批量消息中的每条消息调用一次。
+   *
+   * @throws std::runtime_error 如果批量消息格式错误。
+   */
+  template <class MessageType, typename Callback>
+  void SubscribeListNoWait(const std::string& topic_name, const std::string& shm_name, Callback callback) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER, true);
+    if (endpoint.TryWait(notifier)) {
+      MessageType msg;
+      endpoint.Snapshot(MakeBatchReader(msg, callback));
+    }
+  }
+
+  /**
+   * @brief 订阅 `PublishList` 发布的批量消息并设置超时时间。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param callback 处理接收消息的回调函数，批量消息中的每条消息调用一次。
+   * @param timeout 等待的超时时间（毫秒）。
+   *
+   * @throws std::runtime_error 如果批量消息格式错误。
+   */
+  template <class MessageType, typename Callback>
+  void SubscribeListTimeout(const std::string& topic_name, const std::string& shm_name, Callback callback, int timeout) {
+    auto& notifier = GetNotifier(topic_name, shm_name);
+    auto& endpoint = GetAdvertisedEndpoint<MessageType>(topic_name, shm_name, ShmRole::SUBSCRIBER, true);
+    if (endpoint.WaitTimeout(notifier, timeout)) {
+      MessageType msg;
+      endpoint.Snapshot(MakeBatchReader(msg, callback));
+    }
+  }
+
+ private:
+  /**
+   * @brief 获取批量消息的类型哈希。
+   *
+   * @tparam MessageType 批量消息中的消息类型。
+   * @return 消息类型哈希与 `SHM_BATCH_HASH_SALT` 的异或。
+   */
+  template <class MessageType>
+  static int64_t GetBatchTypeHash() {
+    return SerializerPolicy<MessageType>::GetTypeHash() ^ SHM_BATCH_HASH_SALT;
+  }
+
+  /**
+   * @brief 获取共享内存段的端点，并在首次以 `role` 使用时登记到话题注册表。
+   *
+   * 类型名称只在首次登记时构造，之后的发布和订阅只检查本进程内的标志，不分配内存也不访问注册表。
+   *
+   * @tparam MessageType 消息类型，批量消息时为其中的单条消息类型。
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param role 本进程在话题中的角色。
+   * @param batch 是否为 `PublishList` 发布的批量消息，类型名称以 `[]` 结尾。
+   * @return 共享内存段的端点。
+   */
+  template <class MessageType>
+  SharedMemoryEndpoint& GetAdvertisedEndpoint(const std::string& topic_name, const std::string& shm_name, ShmRole role, bool batch = false) {
+    auto& endpoint = GetEndpoint(topic_name, shm_name, batch ? GetBatchTypeHash<MessageType>() : SerializerPolicy<MessageType>::GetTypeHash());
+    if (!endpoint.IsAdvertised(role)) {
+      endpoint.Advertise(topic_name, SerializerPolicy<MessageType>::GetTypeName() + (batch ? "[]" : ""), role);
+    }
+    return endpoint;
+  }
+
+  /**
+   * @brief 生成将数据解码到 `msg` 的函数。
+   *
+   * @tparam MessageType 消息类型。
+   * @param msg 解码目标。
+   * @return 解码函数。
+   */
+  template <class MessageType>
+  static auto MakeDecoder(MessageType& msg) {
+    return [&msg](const uint8_t* data, size_t size) { SerializerPolicy<MessageType>::Deserialize(data, size, msg); };
+  }
+
+  /**
+   * @brief 生成逐条解码批量消息的读取函数。
+   *
+   * @tparam MessageType 订阅的消息类型。
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param msg 复用的解码目标。
+   * @param callback 处理接收消息的回调函数。
+   * @return 供 `SharedMemoryEndpoint::Snapshot` 使用的读取函数。
+   */
+  template <class MessageType, typename Callback>
+  static auto MakeBatchReader(MessageType& msg, Callback& callback) {
+    return [&msg, &callback](const uint8_t* data, size_t size) {
+      ForEachBatchMessage(data, size, [&](const uint8_t* frame, size_t length) {
+        SerializerPolicy<MessageType>::Deserialize(frame, length, msg);
+        callback(msg);
+      });
+    };
+  }
+
+  /**
+   * @brief 将消息写入共享内存段。
+   *
+   * 将 `msg` 编码到由 `shm_name` 标识的共享内存段中，并在话题注册表中登记为 `topic_name` 的发布者。
+   *
+   * @tparam MessageType 要写入的消息类型，可以是消息或指向消息的指针。
+   * @param topic_name 发布到的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param msg 要写入的消息或指向它的指针。
+   *
+   * @throws std::runtime_error 如果写入共享内存失败。
+   */
+  template <class MessageType>
+  void WriteDataToSHM(const std::string& topic_name, const std::string& shm_name, const MessageType& msg) {
+    const auto& message = DerefMessage(msg);
+    using Message = std::remove_cvref_t<decltype(message)>;
+    size_t size = SerializerPolicy<Message>::GetSize(message);
+    auto& endpoint = GetAdvertisedEndpoint<Message>(topic_name, shm_name, ShmRole::PUBLISHER);
+    endpoint.Write(size, [&](uint8_t* dst) { SerializerPolicy<Message>::Serialize(message, dst, size); });
+  }
+
+  /**
+   * @brief 获取主题在共享内存段上的端点。
+   *
+   * 端点保存读取位置，每个主题和共享内存段的组合各有一个，同一段上的多个主题互不影响读取位置。
+   * 如果端点不存在，则按 `SetOption` 设置的选项创建一个新的，共享内存段在首次读写时打开。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param type_hash 消息类型哈希，仅在创建端点时使用。
+   * @return 主题在共享内存段上的端点。
+   */
+  SharedMemoryEndpoint& GetEndpoint(const std::string& topic_name, const std::string& shm_name, int64_t type_hash) {
+    auto& endpoints = endpoint_map_[shm_name];
+    auto endpoint = endpoints.find(topic_name);
+    if (endpoint == endpoints.end()) {
+      auto option = option_map_.find(shm_name);
+      auto created =
+          std::make_shared<SharedMemoryEndpoint>(shm_name, option == option_map_.end() ? SharedMemoryOption{} : option->second, type_hash);
+      endpoint = endpoints.emplace(topic_name, created).first;
+    }
+    return *endpoint->second;
+  }
+
+  /**
+   * @brief 查找主题在共享内存段上已有的端点。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @return 端点，尚未发布或订阅时返回 `nullptr`。
+   */
+  const SharedMemoryEndpoint* FindEndpoint(const std::string& topic_name, const std::string& shm_name) const {
+    auto endpoints = endpoint_map_.find(shm_name);
+    if (endpoints == endpoint_map_.end()) {
+      return nullptr;
+    }
+    auto endpoint = endpoints->second.find(topic_name);
+    return endpoint == endpoints->second.end() ? nullptr : endpoint->second.get();
+  }
+
+  /**
+   * @brief 获取主题的通知器。
+   *
+   * 如果与 `topic_name` 关联的通知器不存在，则按 `shm_name` 的选项中的通知方式创建一个新的。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   * @return 主题的通知器。
+   *
+   * @throws std::runtime_error 如果创建或访问通知器失败。
+   */
+  SharedMemoryNotifier& GetNotifier(const std::string& topic_name, const std::string& shm_name) {
+    auto notifier = notifier_map_.find(topic_name);
+    if (notifier == notifier_map_.end()) {
+      auto option = option_map_.find(shm_name);
+      auto mode = option == option_map_.end() ? ShmNotifyMode::SEMAPHORE : option->second.notify_mode;
+      notifier = notifier_map_.emplace(topic_name, std::make_shared<SharedMemoryNotifier>(topic_name, mode)).first;
+      if (option != option_map_.end()) {
+        notifier->second->SetDecimation(option->second.decimation);
+      }
+    }
+    return *notifier->second;
+  }
+
+  using EndpointMap = std::unordered_map<std::string, std::shared_ptr<SharedMemoryEndpoint>>;
+
+  std::unordered_map<std::string, EndpointMap> endpoint_map_;                           /**< 共享内存段名称、主题名称两级键的端点映射。 */
+  std::unordered_map<std::string, std::shared_ptr<SharedMemoryNotifier>> notifier_map_; /**< 主题名称键的通知器映射。 */
+  std::unordered_map<std::string, SharedMemoryOption> option_map_;                      /**< 共享内存段名称键的创建选项映射。 */
+  std::vector<uint32_t> batch_sizes_;                                                   /**< 批量发布时复用的每条消息编码长度。 */
+};
+
+/**
+ * @brief 预绑定的共享内存话题发布者。
+ *
+ * `SharedMemoryPublisher` 在构造时解析话题的通知器，在首次发布时按消息大小打开共享内存段，
+ * 之后每次发布直接序列化到已映射的共享内存并通知订阅者，不再进行字符串查找或分配。
+ *
+ * @tparam MessageType 发布消息的类型。
+ * @tparam SerializerPolicy 序列化策略类模板，接口见 `LcmSerializer`。
+ */
+template <class MessageType, template <class> class SerializerPolicy>
+class SharedMemoryPublisher {
+ public:
+  /**
+   * @brief 构造发布者。
+   *
+   * @param topic_name 发布到的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param option 创建共享内存段时使用的选项。
+   *
+   * @throws std::runtime_error 如果创建或访问通知器失败。
+   */
+  SharedMemoryPublisher(const std::string& topic_name, const std::string& shm_name, const SharedMemoryOption& option = SharedMemoryOption{})
+      : notifier_(topic_name, option.notify_mode), endpoint_(shm_name, option, SerializerPolicy<MessageType>::GetTypeHash()) {
+    endpoint_.Advertise(topic_name, SerializerPolicy<MessageType>::GetTypeName(), ShmRole::PUBLISHER);
+  }
+
+  /**
+   * @brief 发布消息。
+   *
+   * @param msg 要发布的消息。
+   *
+   * @throws std::runtime_error 如果写入共享内存或发送通知失败。
+   */
+  void Publish(const MessageType& msg) {
+    size_t size = SerializerPolicy<MessageType>::GetSize(msg);
+    endpoint_.Write(size, [&](uint8_t* dst) { SerializerPolicy<MessageType>::Serialize(msg, dst, size); });
+    notifier_.Notify();
+  }
+
+  /**
+   * @brief 检查最近一次发布的通知是否已被订阅者取走。
+   *
+   * 可用于按订阅者的处理进度发布，例如日志回放时避免覆盖订阅者尚未读取的消息。
+   *
+   * @return 已被取走或尚未发布过时返回 `true`。
+   */
+  bool IsConsumed() const { return notifier_.IsConsumed(); }
+
+ private:
+  SharedMemoryNotifier notifier_; /**< 主题的通知器。 */
+  SharedMemoryEndpoint endpoint_; /**< 共享内存段的端点。 */
+};
+
+/**
+ * @brief 预绑定的共享内存话题订阅者。
+ *
+ * `SharedMemorySubscriber` 在构造时解析话题的通知器，在首次收到通知时打开共享内存段，
+ * 之后每次订阅直接读取已映射的共享内存，不再进行字符串查找或分配。
+ * 每个订阅者持有自己的读取状态，环形布局下互不影响。
+ *
+ * @tparam MessageType 订阅的消息类型。
+ * @tparam SerializerPolicy 序列化策略类模板，接口见 `LcmSerializer`。
+ */
+template <class MessageType, template <class> class SerializerPolicy>
+class SharedMemorySubscriber {
+ public:
+  /**
+   * @brief 构造订阅者。
+   *
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param option 共享内存段的选项，其中的通知方式需要与发布者一致，最大交付频率和抽取因子只作用于本订阅者。
+   *
+   * @throws std::runtime_error 如果创建或访问通知器失败。
+   */
+  SharedMemorySubscriber(const std::string& topic_name, const std::string& shm_name, const SharedMemoryOption& option = SharedMemoryOption{})
+      : notifier_(topic_name, option.notify_mode), endpoint_(shm_name, option, SerializerPolicy<MessageType>::GetTypeHash()) {
+    notifier_.SetDecimation(option.decimation);
+    endpoint_.Advertise(topic_name, SerializerPolicy<MessageType>::GetTypeName(), ShmRole::SUBSCRIBER);
+  }
+
+  /**
+   * @brief 等待消息并使用回调处理。
+   *
+   * 环形布局下依次对所有未读消息调用 `callback`。
+   *
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param callback 处理接收消息的回调函数。
+   *
+   * @throws std::runtime_error 如果访问共享内存或通知器失败。
+   */
+  template <typename Callback>
+  void Subscribe(Callback callback) {
+    do {
+      endpoint_.Wait(notifier_);
+    } while (endpoint_.Read(Decoder(), [&] { callback(msg_); }) == 0);
+  }
+
+  /**
+   * @brief 不阻塞地尝试接收消息。
+   *
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param callback 处理接收消息的回调函数。
+   * @return 收到消息时返回 `true`。
+   */
+  template <typename Callback>
+  bool SubscribeNoWait(Callback callback) {
+    return endpoint_.TryWait(notifier_) && endpoint_.Read(Decoder(), [&] { callback(msg_); }) > 0;
+  }
+
+  /**
+   * @brief 在超时时间内等待消息。
+   *
+   * @tparam Callback 处理接收消息的回调函数类型。
+   * @param callback 处理接收消息的回调函数。
+   * @param timeout 等待的超时时间（毫秒）。
+   * @return 收到消息时返回 `true`，超时时返回 `false`。
+   */
+  template <typename Callback>
+  bool SubscribeTimeout(Callback callback, int timeout) {
+    return endpoint_.WaitTimeout(notifier_, timeout) && endpoint_.Read(Decoder(), [&] { callback(msg_); }) > 0;
+  }
+
+  /**
+   * @brief 获取环形布局下因缓冲区溢出而丢弃的消息数量。
+   *
+   * @return 累计丢弃的消息数量。
+   */
+  uint64_t GetDroppedCount() const { return endpoint_.GetDroppedCount(); }
+
+  /**
+   * @brief 设置消息的最大时效，过期的消息不交给回调。
+   *
+   * @param nanoseconds 最大时效（纳秒），为 0 时不检查。
+   */
+  void SetMaxAge(uint64_t nanoseconds) { endpoint_.SetMaxAge(nanoseconds); }
+
+  /**
+   * @brief 获取最近一次收到的消息头部。
+   *
+   * @return 消息头部，裸数据段时各字段为 0。
+   */
+  const SharedMemoryMessageHeader& GetMessageHeader() const { return endpoint_.GetMessageHeader(); }
+
+  /**
+   * @brief 获取主题的通知器，供 `SharedMemoryWaitSet` 等待。
+   *
+   * @return 主题的通知器。
+   */
+  SharedMemoryNotifier& GetNotifier() { return notifier_; }
+
+  /**
+   * @brief 获取共享内存段的端点，供 `SharedMemoryWaitSet` 检查未读消息。
+   *
+   * @return 共享内存段的端点。
+   */
+  SharedMemoryEndpoint& GetEndpoint() { return endpoint_; }
+
+ private:
+  /**
+   * @brief 获取将数据解码到 `msg_` 的函数。
+   *
+   * @return 解码函数。
+   */
+  auto Decoder() {
+    return [this](const uint8_t* data, size_t size) { SerializerPolicy<MessageType>::Deserialize(data, size, msg_); };
+  }
+
+  SharedMemoryNotifier notifier_; /**< 主题的通知器。 */
+  SharedMemoryEndpoint endpoint_; /**< 共享内存段的端点。 */
+  MessageType msg_;               /**< 复用的消息对象。 */
+};
+
+}  // namespace ocm
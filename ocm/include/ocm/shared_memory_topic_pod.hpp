@@ -0,0 +1,213 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "ocm/shared_memory_serializer.hpp"
+
+namespace ocm {
+/**
+ * @brief 定长消息的零拷贝共享内存话题发布者。
+ *
+ * `SharedMemoryPublisherPod` 面向关节状态数组、IMU 采样等可平凡复制的定长消息，
+ * 不经过序列化：`Loan` 直接返回指向共享内存的消息指针，调用者原地填写后 `Commit` 发布。
+ * 共享内存段按 `sizeof(MessageType)` 创建。
+ *
+ * @tparam MessageType 发布消息的类型。必须可平凡复制。
+ */
+template <class MessageType>
+class SharedMemoryPublisherPod {
+  static_assert(std::is_trivially_copyable_v<MessageType>, "SharedMemoryPublisherPod requires a trivially copyable message type");
+  static_assert(alignof(MessageType) <= 64, "SharedMemoryPublisherPod requires a message alignment of at most 64 bytes");
+
+ public:
+  /**
+   * @brief 构造发布者。
+   *
+   * @param topic_name 发布到的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param option 创建共享内存段时使用的选项。
+   *
+   * @throws std::runtime_error 如果创建或访问通知器失败。
+   */
+  SharedMemoryPublisherPod(const std::string& topic_name, const std::string& shm_name, const SharedMemoryOption& option = SharedMemoryOption{})
+      : notifier_(topic_name, option.notify_mode), endpoint_(shm_name, option, GetPodTypeHash<MessageType>()) {
+    endpoint_.Advertise(topic_name, typeid(MessageType).name(), ShmRole::PUBLISHER);
+  }
+
+  /**
+   * @brief 借出共享内存中的消息，供调用者原地填写。
+   *
+   * 写锁一直持有到 `Commit`，期间不得再次调用 `Loan`。单槽位布局下返回的消息保留上一次发布的内容，
+   * 环形和三缓冲布局下为新槽位，需要完整填写。
+   *
+   * @return 指向共享内存中消息的指针。
+   *
+   * @throws std::runtime_error 如果访问共享内存失败。
+   */
+  MessageType* Loan() { return reinterpret_cast<MessageType*>(endpoint_.Loan(sizeof(MessageType))); }
+
+  /**
+   * @brief 发布 `Loan` 借出的消息并通知订阅者。
+   *
+   * @throws std::runtime_error 如果发送通知失败。
+   */
+  void Commit() {
+    endpoint_.Commit(sizeof(MessageType));
+    notifier_.Notify();
+  }
+
+  /**
+   * @brief 拷贝并发布消息。
+   *
+   * @param msg 要发布的消息。
+   *
+   * @throws std::runtime_error 如果写入共享内存或发送通知失败。
+   */
+  void Publish(const MessageType& msg) {
+    *Loan() = msg;
+    Commit();
+  }
+
+ private:
+  SharedMemoryNotifier notifier_; /**< 主题的通知器。 */
+  SharedMemoryEndpoint endpoint_; /**< 共享内存段的端点。 */
+};
+
+/**
+ * @brief 定长消息的零拷贝共享内存话题订阅者。
+ *
+ * `SharedMemorySubscriberPod` 不经过反序列化，回调直接收到指向共享内存中消息的常量引用。
+ * 信号量和健壮互斥锁模式下回调在锁内执行；顺序锁模式和环形布局下回调无锁执行，
+ * 若期间消息被发布者覆盖则重新调用回调，因此回调只应读取消息，需要保留的数据应自行拷贝；
+ * 三缓冲布局下回调在读者独占的缓冲区上无锁执行一次。
+ *
+ * @tparam MessageType 订阅的消息类型。必须可平凡复制。
+ */
+template <class MessageType>
+class SharedMemorySubscriberPod {
+  static_assert(std::is_trivially_copyable_v<MessageType>, "SharedMemorySubscriberPod requires a trivially copyable message type");
+
+ public:
+  /**
+   * @brief 构造订阅者。
+   *
+   * @param topic_name 要订阅的主题名。
+   * @param shm_name 共享内存段的名称。
+   * @param option 共享内存段的选项，其中的通知方式需要与发布者一致，最大交付频率和抽取因子只作用于本订阅者。
+   *
+   * @throws std::runtime_error 如果创建或访问通知器失败。
+   */
+  SharedMemorySubscriberPod(const std::string& topic_name, const std::string& shm_name, const SharedMemoryOption& option = SharedMemoryOption{})
+      : notifier_(topic_name, option.notify_mode), endpoint_(shm_name, option, GetPodTypeHash<MessageType>()) {
+    notifier_.SetDecimation(option.decimation);
+    endpoint_.Advertise(topic_name, typeid(MessageType).name(), ShmRole::SUBSCRIBER);
+  }
+
+  /**
+   * @brief 等待消息并使用回调访问。
+   *
+   * 环形布局下依次对所有未读消息调用 `callback`。
+   *
+   * @tparam Callback 访问消息的回调函数类型，签名为 `void(const MessageType&)`。
+   * @param callback 访问消息的回调函数。
+   *
+   * @throws std::runtime_error 如果访问共享内存或通知器失败，或消息大小与 `MessageType` 不符。
+   */
+  template <typename Callback>
+  void Subscribe(Callback callback) {
+    do {
+      endpoint_.Wait(notifier_);
+    } while (endpoint_.View(Viewer(callback)) == 0);
+  }
+
+  /**
+   * @brief 不阻塞地尝试访问消息。
+   *
+   * @tparam Callback 访问消息的回调函数类型，签名为 `void(const MessageType&)`。
+   * @param callback 访问消息的回调函数。
+   * @return 收到消息时返回 `true`。
+   *
+   * @throws std::runtime_error 如果消息大小与 `MessageType` 不符。
+   */
+  template <typename Callback>
+  bool SubscribeNoWait(Callback callback) {
+    return endpoint_.TryWait(notifier_) && endpoint_.View(Viewer(callback)) > 0;
+  }
+
+  /**
+   * @brief 在超时时间内等待消息。
+   *
+   * @tparam Callback 访问消息的回调函数类型，签名为 `void(const MessageType&)`。
+   * @param callback 访问消息的回调函数。
+   * @param timeout 等待的超时时间（毫秒）。
+   * @return 收到消息时返回 `true`，超时时返回 `false`。
+   *
+   * @throws std::runtime_error 如果消息大小与 `MessageType` 不符。
+   */
+  template <typename Callback>
+  bool SubscribeTimeout(Callback callback, int timeout) {
+    return endpoint_.WaitTimeout(notifier_, timeout) && endpoint_.View(Viewer(callback)) > 0;
+  }
+
+  /**
+   * @brief 获取环形布局下因缓冲区溢出而丢弃的消息数量。
+   *
+   * @return 累计丢弃的消息数量。
+   */
+  uint64_t GetDroppedCount() const { return endpoint_.GetDroppedCount(); }
+
+  /**
+   * @brief 设置消息的最大时效，过期的消息不交给回调。
+   *
+   * @param nanoseconds 最大时效（纳秒），为 0 时不检查。
+   */
+  void SetMaxAge(uint64_t nanoseconds) { endpoint_.SetMaxAge(nanoseconds); }
+
+  /**
+   * @brief 获取最近一次收到的消息头部。
+   *
+   * @return 消息头部，裸数据段时各字段为 0。
+   */
+  const SharedMemoryMessageHeader& GetMessageHeader() const { return endpoint_.GetMessageHeader(); }
+
+  /**
+   * @brief 获取主题的通知器，供 `SharedMemoryWaitSet` 等待。
+   *
+   * @return 主题的通知器。
+   */
+  SharedMemoryNotifier& GetNotifier() { return notifier_; }
+
+  /**
+   * @brief 获取共享内存段的端点，供 `SharedMemoryWaitSet` 检查未读消息。
+   *
+   * @return 共享内存段的端点。
+   */
+  SharedMemoryEndpoint& GetEndpoint() { return endpoint_; }
+
+ private:
+  /**
+   * @brief 获取将共享内存数据作为 `MessageType` 交给回调的函数。
+   *
+   * @param callback 访问消息的回调函数。
+   * @return 访问函数。
+   */
+  template <typename Callback>
+  static auto Viewer(Callback& callback) {
+    return [&callback](const uint8_t* data, size_t size) {
+      if (size < sizeof(MessageType)) {
+        throw std::runtime_error("[SharedMemorySubscriberPod] Message of " + std::to_string(size) + " bytes is smaller than the expected " +
+                                 std::to_string(sizeof(MessageType)));
+      }
+      callback(*reinterpret_cast<const MessageType*>(data));
+    };
+  }
+
+  SharedMemoryNotifier notifier_; /**< 主题的通知器。 */
+  SharedMemoryEndpoint endpoint_; /**< 共享内存段的端点。 */
+};
+
+}  // namespace ocm
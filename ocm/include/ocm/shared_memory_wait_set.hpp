@@ -0,0 +1,128 @@
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+
+namespace ocm {
+/**
+ * @brief 共享内存话题等待集。
+ *
+ * `SharedMemoryWaitSet` 让一个线程在一次调用中同时等待多个话题和定时器，任一就绪即返回，
+ * 并给出所有就绪条目的索引。等待集只检查通知而不消耗它，调用者随后对就绪的订阅者调用
+ * `SubscribeNoWait` 取出消息，对未就绪的订阅者无需轮询。
+ *
+ * 所有话题均使用 `ShmNotifyMode::FUTEX` 时，等待集通过 `futex_waitv` 在内核中同时等待各话题的通知段；
+ * 含有信号量通知的话题或内核不支持 `futex_waitv` 时，退化为以 `kPollInterval` 为间隔的轮询。
+ * 定时器按固定周期就绪，不累积漂移。设置了最大交付频率的订阅者在下一次允许交付的时刻之前不就绪，
+ * 等待集也不等待它的通知，而是最多睡眠到该时刻。
+ */
+class SharedMemoryWaitSet {
+ public:
+  /**
+   * @brief 轮询方式下两次检查之间的最长间隔（纳秒）。
+   */
+  static constexpr uint64_t kPollInterval = 200000;
+
+  /**
+   * @brief 默认构造函数。
+   */
+  SharedMemoryWaitSet() = default;
+
+  /**
+   * @brief 加入一个话题。
+   *
+   * @param notifier 话题的通知器，需在等待集的生命周期内有效。
+   * @param endpoint 话题的端点，用于检查环形布局中剩余的未读消息和限速的交付时刻，可为空。
+   * @return 条目索引。
+   */
+  size_t Attach(SharedMemoryNotifier& notifier, SharedMemoryEndpoint* endpoint = nullptr);
+
+  /**
+   * @brief 加入一个订阅者。
+   *
+   * @tparam Subscriber 订阅者类型，需提供 `GetNotifier` 和 `GetEndpoint`。
+   * @param subscriber 订阅者，需在等待集的生命周期内有效。
+   * @return 条目索引。
+   */
+  template <class Subscriber>
+  size_t Attach(Subscriber& subscriber) {
+    return Attach(subscriber.GetNotifier(), &subscriber.GetEndpoint());
+  }
+
+  /**
+   * @brief 加入一个周期定时器。
+   *
+   * 定时器从加入时开始计时，每经过一个周期就绪一次。
+   *
+   * @param period_nanoseconds 定时周期（纳秒），必须大于 0。
+   * @return 条目索引。
+   *
+   * @throws std::runtime_error 如果周期为 0。
+   */
+  size_t AttachTimer(uint64_t period_nanoseconds);
+
+  /**
+   * @brief 阻塞等待任一条目就绪。
+   *
+   * @return 就绪条目的索引，按加入顺序排列。
+   *
+   * @throws std::runtime_error 如果等待集为空或等待失败。
+   */
+  const std::vector<size_t>& Wait();
+
+  /**
+   * @brief 在超时时间内等待任一条目就绪。
+   *
+   * @param milliseconds 等待的超时时间（毫秒），按 `CLOCK_MONOTONIC` 计时。
+   * @return 就绪条目的索引，按加入顺序排列；超时时为空。
+   *
+   * @throws std::runtime_error 如果等待失败。
+   */
+  const std::vector<size_t>& WaitTimeout(uint64_t milliseconds);
+
+ private:
+  /**
+   * @brief 等待集中的条目。
+   */
+  struct Entry {
+    SharedMemoryNotifier* notifier = nullptr; /**< 话题的通知器，定时器条目为空。 */
+    SharedMemoryEndpoint* endpoint = nullptr; /**< 话题的端点，可为空。 */
+    uint64_t period = 0;                      /**< 定时器的周期（纳秒）。 */
+    uint64_t next_time = 0;                   /**< 定时器下一次就绪的时刻。 */
+    bool held = false;                        /**< 话题限速且未到交付时刻，本轮不等待它的通知。 */
+  };
+
+  /**
+   * @brief 等待直到任一条目就绪或到达截止时间。
+   *
+   * @param deadline `CLOCK_MONOTONIC` 下的绝对截止时间（纳秒），为 0 时一直等待。
+   * @return 就绪条目的索引。
+   *
+   * @throws std::runtime_error 如果等待失败。
+   */
+  const std::vector<size_t>& WaitUntil(uint64_t deadline);
+
+  /**
+   * @brief 阻塞直到可能有条目就绪或到达唤醒时刻。
+   *
+   * @param wake_time `CLOCK_MONOTONIC` 下的绝对唤醒时刻（纳秒），为 0 时不限。
+   *
+   * @throws std::runtime_error 如果等待失败。
+   */
+  void Block(uint64_t wake_time);
+
+  std::vector<Entry> entries_;                  /**< 等待集中的条目。 */
+  std::vector<size_t> ready_;                   /**< 最近一次等待得到的就绪条目索引。 */
+  std::vector<SharedMemoryNotifier*> notifiers_; /**< 本轮阻塞等待的通知器，容量在加入话题时预留。 */
+  bool waitv_supported_ = true;                  /**< 内核是否支持 `futex_waitv`。 */
+#ifdef SYS_futex_waitv
+  std::vector<struct futex_waitv> waiters_; /**< 本轮传给 `futex_waitv` 的等待项，容量在加入话题时预留。 */
+#endif
+};
+
+}  // namespace ocm
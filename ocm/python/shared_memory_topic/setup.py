@@ -1,6 +1,24 @@
 # setup.py
 
-from setuptools import setup, find_packages
+import os
+from setuptools import setup, find_packages, Extension
+
+# OCM 与第三方依赖的安装位置，可通过环境变量覆盖
+ocm_root = os.environ.get('OCM_ROOT', '/opt/openrobotlib/ocm')
+third_party_root = os.environ.get('OCM_THIRD_PARTY_ROOT', '/opt/openrobotlib/third_party')
+
+# 原生扩展，构建失败时（如未安装 OCM）回退到纯 Python 实现
+native = Extension(
+    'shared_memory_topic._native',
+    sources=['src/shared_memory_topic_native.cpp'],
+    include_dirs=[os.path.join(ocm_root, 'include'), os.path.join(third_party_root, 'include')],
+    library_dirs=[os.path.join(ocm_root, 'lib'), os.path.join(third_party_root, 'lib')],
+    runtime_library_dirs=[os.path.join(ocm_root, 'lib'), os.path.join(third_party_root, 'lib')],
+    libraries=['OCM'],
+    extra_compile_args=['-std=c++20', '-O3'],
+    language='c++',
+    optional=True,
+)
 
 setup(
     name='shared_memory_topic',  # 包名
@@ -10,9 +28,13 @@ setup(
     description='共享内存话题, 用于进程间通信',
     url='', 
     packages=find_packages(),
+    ext_modules=[native],
     install_requires=[
         'posix_ipc'
     ],
+    extras_require={
+        'numpy': ['numpy'],  # ArrayView、StructView 零拷贝数组视图
+    },
     classifiers=[
         'Programming Language :: Python :: 3',
         'License :: OSI Approved :: MIT License', 
@@ -1,7 +1,17 @@
 # shared_memory_topic/__init__.py
 
-from .shared_memory_topic import SharedMemorySemaphore
 from .shared_memory_topic import SharedMemory
-from .shared_memory_topic import SharedMemoryTopic
+from .shared_memory_topic import ArrayView
+from .shared_memory_topic import StructView
 
-__all__ = ['SharedMemorySemaphore', 'SharedMemory', 'SharedMemoryTopic']
+# 优先使用原生扩展，未构建时回退到纯 Python 实现，接口相同
+try:
+    from ._native import SharedMemorySemaphore
+    from ._native import SharedMemoryTopic
+    NATIVE = True
+except ImportError:
+    from .shared_memory_topic import SharedMemorySemaphore
+    from .shared_memory_topic import SharedMemoryTopic
+    NATIVE = False
+
+__all__ = ['SharedMemorySemaphore', 'SharedMemory', 'SharedMemoryTopic', 'ArrayView', 'StructView', 'NATIVE']
@@ -1,6 +1,39 @@
 import posix_ipc
 import mmap
-    
+import os
+import struct
+import time
+
+# 带头部共享内存段的魔数与布局版本，与 ocm/shared_memory_header.hpp 保持一致
+SHM_HEADER_MAGIC = 0x4F434D53484D0001
+SHM_HEADER_VERSION = 7
+# 段头部大小，以及其中前缀字段、单槽位消息头部和 payload_invalid 的布局
+SHM_HEADER_SIZE = 192
+SHM_HEADER_PREFIX = struct.Struct("=QIBBB")
+SHM_MESSAGE_OFFSET = 80
+SHM_MESSAGE_HEADER = struct.Struct("=QQqIi")
+SHM_PAYLOAD_INVALID_OFFSET = 14
+# 带头部的段上不持锁解码时，检测到写者后重试的次数，之后改为持锁解码
+SHM_UNLOCKED_READ_RETRIES = 3
+
+def ArrayView(view, dtype, shape=None):
+    """将消息视图解释为 numpy 数组，不拷贝数据。
+
+    数组与视图共享共享内存，只在订阅回调内有效，回调返回前需释放对它的引用。
+    """
+    import numpy
+    dtype = numpy.dtype(dtype)
+    array = numpy.frombuffer(view, dtype=dtype, count=len(view) // dtype.itemsize)
+    return array if shape is None else array.reshape(shape)
+
+def StructView(view, dtype):
+    """将定长消息视图解释为结构化 numpy 标量数组，按字段名访问，不拷贝数据。
+
+    dtype 需与 C++ 消息结构体的内存布局一致，通常以 numpy.dtype([...], align=True) 构造。
+    """
+    import numpy
+    return numpy.frombuffer(view, dtype=dtype, count=1).reshape(())
+
 class SharedMemorySemaphore:
     def __init__(self, name: str, initial_value: int):
         try:
@@ -32,6 +65,9 @@ class SharedMemorySemaphore:
             success = False
         return success
     
+    def GetValue(self):
+        return self.semaphore.value
+
     def DecrementTimeout(self, timeout: int):
         success = True
         try:
@@ -59,19 +95,90 @@ class SharedMemory:
         except posix_ipc.ExistentialError:
             self.shm = posix_ipc.SharedMemory(self.name)
             print(f"共享内存{name}已存在，已打开")
-            if self.check_size:
-                if self.shm.size != self.size:
-                    raise Exception("共享内存大小不一致")
-            self.size = self.shm.size
-        self.data = mmap.mmap(self.shm.fd, self.size)
-    
+        self.data = mmap.mmap(self.shm.fd, self.shm.size)
+        self.ParseHeader()
+        if self.check_size:
+            if self.offset == 0 and self.capacity != self.size:
+                raise Exception("共享内存大小不一致")
+            if self.offset != 0 and self.capacity < self.size:
+                raise Exception("共享内存容量不足")
+        self.size = self.shm.size
+
+    def ParseHeader(self):
+        """识别 C++ 端以非默认选项创建的带头部段。
+
+        仅支持信号量锁模式的单槽位布局，即只设置了 capacity 的段；其他锁模式和布局需使用 C++ 客户端。
+        """
+        self.offset = 0
+        self.capacity = self.shm.size
+        if self.shm.size < SHM_HEADER_SIZE:
+            return
+        magic, version, lock_mode, layout, _ = SHM_HEADER_PREFIX.unpack_from(self.data, 0)
+        if magic != SHM_HEADER_MAGIC:
+            return
+        if version != SHM_HEADER_VERSION:
+            raise Exception(f"共享内存{self.name}头部版本不一致")
+        if lock_mode != 0 or layout != 0:
+            raise Exception(f"共享内存{self.name}的锁模式或布局不受Python客户端支持")
+        self.offset = SHM_HEADER_SIZE
+        self.capacity = struct.unpack_from("=Q", self.data, 16)[0]
+
+    def GetPayloadSize(self):
+        """获取当前消息的有效字节数，裸数据段为整个数据区。调用者需持有锁。"""
+        if self.offset == 0:
+            return self.capacity
+        if self.data[SHM_PAYLOAD_INVALID_OFFSET]:
+            return 0
+        seq, _, _, payload_size, _ = SHM_MESSAGE_HEADER.unpack_from(self.data, SHM_MESSAGE_OFFSET)
+        return 0 if seq == 0 else min(payload_size, self.capacity)
+
     def WriteData(self, data):
-        self.data.seek(0)
-        self.data.write(data)
-    
+        if len(data) > self.capacity:
+            raise Exception(f"消息大小{len(data)}超过共享内存{self.name}的容量{self.capacity}")
+        self.data[self.offset:self.offset + len(data)] = data
+        if self.offset != 0:
+            seq = struct.unpack_from("=Q", self.data, SHM_MESSAGE_OFFSET)[0]
+            SHM_MESSAGE_HEADER.pack_into(self.data, SHM_MESSAGE_OFFSET, seq + 1, time.monotonic_ns(), 0, len(data), os.getpid())
+            self.data[SHM_PAYLOAD_INVALID_OFFSET] = 0
+
     def ReadData(self):
-        self.data.seek(0)
-        return self.data.read()
+        return self.data[self.offset:self.offset + self.GetPayloadSize()]
+
+    def ReadView(self):
+        """获取当前消息的 memoryview，直接映射共享内存，不拷贝数据。
+
+        视图只在持锁期间有效，使用完毕后需调用 release()。
+        """
+        return memoryview(self.data)[self.offset:self.offset + self.GetPayloadSize()]
+
+    def ReadSeq(self):
+        """获取当前消息的序号，0 表示尚无消息。仅用于带头部的段。"""
+        return struct.unpack_from("=Q", self.data, SHM_MESSAGE_OFFSET)[0]
+
+    def TryViewUnlocked(self, reader):
+        """不持锁地以当前消息的 memoryview 调用 reader，以锁状态和消息序号验证期间没有写入。
+
+        写者持锁写入数据后才递增序号，因此读取前后锁都空闲且序号不变时，读取期间没有写者。
+        reader 可能读到被覆盖的数据，只应解码而不应产生副作用；验证失败时丢弃其结果或异常。
+
+        Returns:
+            (是否验证通过, reader 的返回值)。裸数据段没有序号，不读取，直接返回 (False, None)。
+        """
+        if self.offset == 0:
+            return False, None
+        seq = self.ReadSeq()
+        if seq == 0 or self.sem.GetValue() == 0:
+            return False, None
+        try:
+            with self.ReadView() as view:
+                result = reader(view)
+        except Exception:
+            if self.sem.GetValue() != 0 and self.ReadSeq() == seq:
+                raise
+            return False, None
+        if self.sem.GetValue() == 0 or self.ReadSeq() != seq:
+            return False, None
+        return True, result
 
     def Lock(self):
         self.sem.Decrement()
@@ -122,26 +229,67 @@ class SharedMemoryTopic:
         self.CheckSemExist(topic_name)
         self.sem[topic_name].Decrement()
         self.CheckSHMExist(shm_name, False)
-        self.shm[shm_name].Lock()
-        data=lcm_type.decode(self.shm[shm_name].ReadData())
-        self.shm[shm_name].UnLock()
+        data=self.Decode(shm_name, lcm_type)
         callback(data)
         
     def SubscribeNoWait(self, topic_name: str, shm_name: str, callback,lcm_type):
         self.CheckSemExist(topic_name)
         if self.sem[topic_name].TryDecrement():
             self.CheckSHMExist(shm_name, False)
-            self.shm[shm_name].Lock()
-            data=lcm_type.decode(self.shm[shm_name].ReadData())
-            self.shm[shm_name].UnLock()
+            data=self.Decode(shm_name, lcm_type)
             callback(data)
 
     def SubscribeTimeout(self, topic_name: str, shm_name: str, callback, lcm_type, timeout: int):
         self.CheckSemExist(topic_name)
         if self.sem[topic_name].DecrementTimeout(timeout):
             self.CheckSHMExist(shm_name, False)
-            self.shm[shm_name].Lock()
-            data=lcm_type.decode(self.shm[shm_name].ReadData())
-            self.shm[shm_name].UnLock()
+            data=self.Decode(shm_name, lcm_type)
             callback(data)
-            
\ No newline at end of file
+
+    def SubscribeView(self, topic_name: str, shm_name: str, callback):
+        """订阅指定主题，以直接映射共享内存的 memoryview 调用 callback，不拷贝数据。
+
+        注意：callback 在持有共享内存段写锁期间调用，回调返回前该段的所有发布者都被阻塞。
+        回调应尽快返回，耗时的处理应先拷贝所需数据（如 bytes(view) 或 array.copy()），在回调外进行。
+        视图及由 ArrayView、StructView 得到的数组只在回调内有效。
+        """
+        self.CheckSemExist(topic_name)
+        self.sem[topic_name].Decrement()
+        self.CheckSHMExist(shm_name, False)
+        self.View(shm_name, callback)
+
+    def SubscribeViewNoWait(self, topic_name: str, shm_name: str, callback):
+        self.CheckSemExist(topic_name)
+        if self.sem[topic_name].TryDecrement():
+            self.CheckSHMExist(shm_name, False)
+            self.View(shm_name, callback)
+
+    def SubscribeViewTimeout(self, topic_name: str, shm_name: str, callback, timeout: int):
+        self.CheckSemExist(topic_name)
+        if self.sem[topic_name].DecrementTimeout(timeout):
+            self.CheckSHMExist(shm_name, False)
+            self.View(shm_name, callback)
+
+    def Decode(self, shm_name: str, lcm_type):
+        """直接从共享内存解码消息。
+
+        带头部的段先不持锁解码，以消息序号验证期间没有写入，发布者不被解码阻塞；
+        裸数据段没有序号，以及多次检测到写者时，在锁内解码。
+        """
+        def Reader(view):
+            return lcm_type.decode(view)
+        shm = self.shm[shm_name]
+        for _ in range(SHM_UNLOCKED_READ_RETRIES if shm.offset != 0 else 0):
+            valid, data = shm.TryViewUnlocked(Reader)
+            if valid:
+                return data
+        return self.View(shm_name, Reader)
+
+    def View(self, shm_name: str, reader):
+        """持锁以当前消息的 memoryview 调用 reader，返回其返回值。reader 返回前发布者被阻塞。"""
+        self.shm[shm_name].Lock()
+        try:
+            with self.shm[shm_name].ReadView() as view:
+                return reader(view)
+        finally:
+            self.shm[shm_name].UnLock()
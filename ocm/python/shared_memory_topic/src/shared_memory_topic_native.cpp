@@ -0,0 +1,726 @@
+/**
+ * @file shared_memory_topic_native.cpp
+ * @brief 共享内存话题 Python 客户端的原生扩展模块 `shared_memory_topic._native`。
+ *
+ * 以 CPython C API 封装 C++ 的 `SharedMemoryEndpoint`、`SharedMemoryNotifier` 和 `SharedMemorySemaphore`，
+ * 提供与纯 Python 实现相同的 `SharedMemoryTopic` 和 `SharedMemorySemaphore` 接口。加锁、拷贝和等待通知均在 C++ 中完成，
+ * 阻塞等待和读写共享内存期间释放 GIL，只在编码、解码和调用回调时持有 GIL。
+ *
+ * `SubscribeView` 系列与纯 Python 实现一样以直接映射共享内存的 `memoryview` 调用回调，视图在回调返回后释放；
+ * 只有顺序锁模式和环形布局例外，它们无锁读取、被覆盖时需要重读，回调不能重复执行，因此改为交付消息的拷贝。
+ * 注意：信号量和健壮互斥锁模式下回调在持有共享内存段的锁期间调用，回调返回前发布者被阻塞，回调应尽快返回。
+ *
+ * 与纯 Python 实现一致，超时时间以秒为单位。同一对象不应在多个线程中并发使用。
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "ocm/shared_memory_semaphore.hpp"
+
+namespace {
+
+/**
+ * @brief Python 代码抛出异常时用于跳出 C++ 调用栈，异常信息保留在解释器中。
+ */
+struct PythonError {};
+
+/**
+ * @brief 在作用域内释放 GIL，可临时重新获取以调用 Python 代码。
+ */
+class GilRelease {
+ public:
+  GilRelease() : state_(PyEval_SaveThread()) {}
+
+  ~GilRelease() { Acquire(); }
+
+  GilRelease(const GilRelease&) = delete;
+
+  GilRelease& operator=(const GilRelease&) = delete;
+
+  /**
+   * @brief 重新获取 GIL。
+   */
+  void Acquire() {
+    if (state_) {
+      PyEval_RestoreThread(state_);
+      state_ = nullptr;
+    }
+  }
+
+  /**
+   * @brief 再次释放 GIL。
+   */
+  void Release() {
+    if (!state_) {
+      state_ = PyEval_SaveThread();
+    }
+  }
+
+ private:
+  PyThreadState* state_; /**< 释放 GIL 时保存的线程状态，持有 GIL 时为空。 */
+};
+
+/**
+ * @brief 释放 GIL 执行函数，并将 C++ 异常转换为 Python 异常。
+ *
+ * @tparam Function 函数类型，签名为 `void(GilRelease& gil)`。
+ * @param function 要执行的函数，需要调用 Python 代码时通过 `gil` 临时重新获取 GIL。
+ * @return 成功时返回 `true`；失败时返回 `false` 并设置 Python 异常。
+ */
+template <typename Function>
+bool RunWithoutGil(Function&& function) {
+  try {
+    GilRelease gil;
+    function(gil);
+    return true;
+  } catch (const PythonError&) {
+    return false;
+  } catch (const std::exception& e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return false;
+  }
+}
+
+/**
+ * @brief 将以秒为单位的超时时间转换为毫秒。
+ *
+ * @param seconds 超时时间（秒）。
+ * @return 超时时间（毫秒），负数视为 0。
+ */
+uint64_t ToMilliseconds(double seconds) { return seconds > 0 ? static_cast<uint64_t>(seconds * 1000.0) : 0; }
+
+/**
+ * @brief `SharedMemorySemaphore` 的 Python 对象。
+ */
+struct SemaphoreObject {
+  PyObject_HEAD
+  ocm::SharedMemorySemaphore* semaphore; /**< 命名信号量，`Close` 后为空。 */
+};
+
+/**
+ * @brief 获取仍然打开的信号量。
+ *
+ * @param self 信号量对象。
+ * @return 信号量；已关闭时返回空并设置 Python 异常。
+ */
+ocm::SharedMemorySemaphore* GetSemaphore(SemaphoreObject* self) {
+  if (!self->semaphore) {
+    PyErr_SetString(PyExc_RuntimeError, "[SharedMemorySemaphore] Semaphore is closed");
+  }
+  return self->semaphore;
+}
+
+int SemaphoreInit(SemaphoreObject* self, PyObject* args, PyObject* kwargs) {
+  static const char* keywords[] = {"name", "initial_value", nullptr};
+  const char* name = nullptr;
+  unsigned int initial_value = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sI", const_cast<char**>(keywords), &name, &initial_value)) {
+    return -1;
+  }
+  try {
+    auto* semaphore = new ocm::SharedMemorySemaphore(name, initial_value);
+    delete self->semaphore;
+    self->semaphore = semaphore;
+  } catch (const std::exception& e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return -1;
+  }
+  return 0;
+}
+
+void SemaphoreDealloc(SemaphoreObject* self) {
+  delete self->semaphore;
+  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+PyObject* SemaphoreIncrement(SemaphoreObject* self, PyObject*) {
+  auto* semaphore = GetSemaphore(self);
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { semaphore->Increment(); })) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject* SemaphoreIncrementWhenZero(SemaphoreObject* self, PyObject*) {
+  auto* semaphore = GetSemaphore(self);
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { semaphore->IncrementWhenZero(); })) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject* SemaphoreIncrementValue(SemaphoreObject* self, PyObject* args) {
+  unsigned int value = 0;
+  if (!PyArg_ParseTuple(args, "I", &value)) {
+    return nullptr;
+  }
+  auto* semaphore = GetSemaphore(self);
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { semaphore->Increment(value); })) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject* SemaphoreDecrement(SemaphoreObject* self, PyObject*) {
+  auto* semaphore = GetSemaphore(self);
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { semaphore->Decrement(); })) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject* SemaphoreTryDecrement(SemaphoreObject* self, PyObject*) {
+  auto* semaphore = GetSemaphore(self);
+  bool success = false;
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { success = semaphore->TryDecrement(); })) {
+    return nullptr;
+  }
+  return PyBool_FromLong(success);
+}
+
+PyObject* SemaphoreDecrementTimeout(SemaphoreObject* self, PyObject* args) {
+  double timeout = 0.0;
+  if (!PyArg_ParseTuple(args, "d", &timeout)) {
+    return nullptr;
+  }
+  auto* semaphore = GetSemaphore(self);
+  bool success = false;
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { success = semaphore->DecrementTimeout(ToMilliseconds(timeout)); })) {
+    return nullptr;
+  }
+  return PyBool_FromLong(success);
+}
+
+PyObject* SemaphoreClose(SemaphoreObject* self, PyObject*) {
+  delete self->semaphore;
+  self->semaphore = nullptr;
+  Py_RETURN_NONE;
+}
+
+PyObject* SemaphoreDestroy(SemaphoreObject* self, PyObject*) {
+  auto* semaphore = GetSemaphore(self);
+  if (!semaphore || !RunWithoutGil([&](GilRelease&) { semaphore->Destroy(); })) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyMethodDef semaphore_methods[] = {
+    {"Increment", reinterpret_cast<PyCFunction>(SemaphoreIncrement), METH_NOARGS, "增加信号量的值。"},
+    {"IncrementWhenZero", reinterpret_cast<PyCFunction>(SemaphoreIncrementWhenZero), METH_NOARGS, "信号量为 0 时增加信号量的值。"},
+    {"IncrementValue", reinterpret_cast<PyCFunction>(SemaphoreIncrementValue), METH_VARARGS, "将信号量的值增加 value。"},
+    {"Decrement", reinterpret_cast<PyCFunction>(SemaphoreDecrement), METH_NOARGS, "阻塞减少信号量的值，等待期间释放 GIL。"},
+    {"TryDecrement", reinterpret_cast<PyCFunction>(SemaphoreTryDecrement), METH_NOARGS, "不阻塞地尝试减少信号量的值。"},
+    {"DecrementTimeout", reinterpret_cast<PyCFunction>(SemaphoreDecrementTimeout), METH_VARARGS,
+     "在 timeout 秒内等待减少信号量的值，等待期间释放 GIL。"},
+    {"Close", reinterpret_cast<PyCFunction>(SemaphoreClose), METH_NOARGS, "关闭信号量。"},
+    {"Destroy", reinterpret_cast<PyCFunction>(SemaphoreDestroy), METH_NOARGS, "从系统中删除信号量。"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyTypeObject semaphore_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+/**
+ * @brief 订阅时的等待方式。
+ */
+enum class WaitMode {
+  BLOCK,   /**< 阻塞等待 */
+  NO_WAIT, /**< 不等待 */
+  TIMEOUT  /**< 超时等待 */
+};
+
+/**
+ * @brief `SharedMemoryTopic` 的 Python 对象。
+ *
+ * 按名称缓存共享内存段的端点和话题的通知器，默认选项下与纯 Python 实现和 C++ 客户端使用相同的裸数据段和命名信号量。
+ * 带头部的段按头部记录的锁模式和布局读取。
+ */
+struct TopicObject {
+  PyObject_HEAD
+  std::unordered_map<std::string, std::unique_ptr<ocm::SharedMemoryEndpoint>>* endpoints; /**< 共享内存段名称键的端点映射。 */
+  std::unordered_map<std::string, std::unique_ptr<ocm::SharedMemoryNotifier>>* notifiers; /**< 主题名称键的通知器映射。 */
+  std::unordered_map<std::string, PyObject*>* frames;                                     /**< 共享内存段名称键的消息帧缓冲区。 */
+};
+
+/**
+ * @brief 共享内存中一条消息的缓冲区导出对象。
+ *
+ * 以缓冲区协议导出共享内存中的消息数据，并持有话题对象的引用，使端点的映射在所有由它得到的视图和数组释放前保持有效。
+ */
+struct MappedObject {
+  PyObject_HEAD
+  PyObject* owner;     /**< 持有映射的话题对象。 */
+  const uint8_t* data; /**< 共享内存中的消息数据。 */
+  Py_ssize_t size;     /**< 消息的字节数。 */
+};
+
+int MappedGetBuffer(MappedObject* self, Py_buffer* view, int flags) {
+  return PyBuffer_FillInfo(view, reinterpret_cast<PyObject*>(self), const_cast<uint8_t*>(self->data), self->size, 1, flags);
+}
+
+void MappedDealloc(MappedObject* self) {
+  Py_XDECREF(self->owner);
+  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+PyBufferProcs mapped_buffer = {reinterpret_cast<getbufferproc>(MappedGetBuffer), nullptr};
+
+PyTypeObject mapped_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+/**
+ * @brief 获取 Python 类型的名称，用于在话题注册表中登记。
+ *
+ * @param type Python 类型对象，可为空。
+ * @return 类型名称，为空或不是类型对象时为空字符串。
+ */
+std::string GetTypeName(PyObject* type) { return type && PyType_Check(type) ? reinterpret_cast<PyTypeObject*>(type)->tp_name : ""; }
+
+/**
+ * @brief 获取或创建共享内存段的端点，并在首次以某一角色使用时登记到话题注册表。需持有 GIL。
+ *
+ * 类型名称只在登记时构造一次，之后的收发只检查端点的登记标志。
+ *
+ * @param self 话题对象。
+ * @param topic_name 主题名。
+ * @param shm_name 共享内存段的名称。
+ * @param type 消息的 Python 类型，用于登记类型名称，可为空。
+ * @param role 本进程在话题中的角色。
+ * @return 端点。
+ *
+ * @throws std::runtime_error 如果登记失败。
+ */
+ocm::SharedMemoryEndpoint& GetEndpoint(TopicObject* self, const std::string& topic_name, const std::string& shm_name, PyObject* type, ocm::ShmRole role) {
+  auto& endpoint = (*self->endpoints)[shm_name];
+  if (!endpoint) {
+    endpoint = std::make_unique<ocm::SharedMemoryEndpoint>(shm_name);
+  }
+  if (!endpoint->IsAdvertised(role)) {
+    endpoint->Advertise(topic_name, GetTypeName(type), role);
+  }
+  return *endpoint;
+}
+
+/**
+ * @brief 获取或创建话题的通知器。需持有 GIL。
+ *
+ * @param self 话题对象。
+ * @param topic_name 主题名。
+ * @return 通知器。
+ *
+ * @throws std::runtime_error 如果创建信号量失败。
+ */
+ocm::SharedMemoryNotifier& GetNotifier(TopicObject* self, const std::string& topic_name) {
+  auto& notifier = (*self->notifiers)[topic_name];
+  if (!notifier) {
+    notifier = std::make_unique<ocm::SharedMemoryNotifier>(topic_name);
+  }
+  return *notifier;
+}
+
+/**
+ * @brief 将消息拷贝到可复用的消息帧并以其 `memoryview` 调用 `deliver`。需持有 GIL。
+ *
+ * 消息帧是每个共享内存段一个的 `bytearray`。回调返回后仍被引用的消息帧不再复用，
+ * 下一条消息改用新的消息帧，因此回调中得到的视图和数组在回调返回后仍可安全访问。
+ *
+ * @tparam Deliver 交付函数类型，签名为 `PyObject*(PyObject* view)`，返回新引用，失败时返回空。
+ * @param frame 共享内存段的消息帧。
+ * @param data 消息数据。
+ * @param size 消息的字节数。
+ * @param deliver 交付函数。
+ * @return 成功时返回 `true`；失败时返回 `false` 并设置 Python 异常。
+ */
+template <typename Deliver>
+bool DeliverFrame(PyObject*& frame, const uint8_t* data, size_t size, Deliver&& deliver) {
+  if (!frame || Py_REFCNT(frame) > 1) {
+    Py_XDECREF(frame);
+    frame = PyByteArray_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(size));
+    if (!frame) {
+      return false;
+    }
+  } else if (PyByteArray_Resize(frame, static_cast<Py_ssize_t>(size)) != 0) {
+    return false;
+  }
+  if (size != 0) {
+    memcpy(PyByteArray_AS_STRING(frame), data, size);
+  }
+  PyObject* view = PyMemoryView_FromObject(frame);
+  if (!view) {
+    return false;
+  }
+  PyObject* result = deliver(view);
+  Py_DECREF(view);
+  Py_XDECREF(result);
+  return result != nullptr;
+}
+
+/**
+ * @brief 以直接映射共享内存的 `memoryview` 调用 `deliver`，返回后释放视图。需持有 GIL。
+ *
+ * 视图只在 `deliver` 内有效，之后访问视图会抛出 `ValueError`。与纯 Python 实现一致，由视图得到的数组不随视图释放，
+ * 回调返回后其内容可能被之后的消息覆盖，但映射在数组释放前不会解除。
+ *
+ * @tparam Deliver 交付函数类型，签名为 `PyObject*(PyObject* view)`，返回新引用，失败时返回空。
+ * @param owner 持有映射的话题对象。
+ * @param data 共享内存中的消息数据。
+ * @param size 消息的字节数。
+ * @param deliver 交付函数。
+ * @return 成功时返回 `true`；失败时返回 `false` 并设置 Python 异常。
+ */
+template <typename Deliver>
+bool DeliverMapped(PyObject* owner, const uint8_t* data, size_t size, Deliver&& deliver) {
+  auto* mapped = PyObject_New(MappedObject, &mapped_type);
+  if (!mapped) {
+    return false;
+  }
+  Py_INCREF(owner);
+  mapped->owner = owner;
+  mapped->data = data;
+  mapped->size = static_cast<Py_ssize_t>(size);
+  PyObject* view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(mapped));
+  Py_DECREF(mapped);
+  if (!view) {
+    return false;
+  }
+  PyObject* result = deliver(view);
+  // 回调抛出的异常优先于释放视图时的异常
+  PyObject *type = nullptr, *value = nullptr, *traceback = nullptr;
+  PyErr_Fetch(&type, &value, &traceback);
+  PyObject* released = PyObject_CallMethod(view, "release", nullptr);
+  Py_DECREF(view);
+  if (type) {
+    PyErr_Clear();
+    PyErr_Restore(type, value, traceback);
+  }
+  Py_XDECREF(released);
+  Py_XDECREF(result);
+  return result && released;
+}
+
+/**
+ * @brief 等待并读取消息，对每条消息调用 `deliver`。
+ *
+ * 等待通知和读取共享内存期间释放 GIL，只在调用 `deliver` 时持有 GIL。环形布局下依次交付所有未读消息。
+ * `mapped` 为 `true` 且端点对每条消息只访问一次时，`deliver` 直接得到共享内存的视图：锁模式下在锁内调用，
+ * 三缓冲布局下在读者独占的缓冲区上无锁调用；否则先拷贝消息快照，在锁外以消息帧调用 `deliver`。
+ *
+ * @tparam Deliver 交付函数类型，签名为 `PyObject*(PyObject* view)`。
+ * @param self 话题对象。
+ * @param topic_name 主题名。
+ * @param shm_name 共享内存段的名称。
+ * @param type 消息的 Python 类型，可为空。
+ * @param mode 等待方式。
+ * @param timeout 超时时间（秒），仅 `WaitMode::TIMEOUT` 时使用。
+ * @param mapped 是否尽量不拷贝地交付。
+ * @param deliver 交付函数。
+ * @return 成功时返回 `None`；失败时返回空并设置 Python 异常。
+ */
+template <typename Deliver>
+PyObject* Receive(TopicObject* self, const char* topic_name, const char* shm_name, PyObject* type, WaitMode mode, double timeout, bool mapped,
+                  Deliver&& deliver) {
+  ocm::SharedMemoryEndpoint* endpoint = nullptr;
+  ocm::SharedMemoryNotifier* notifier = nullptr;
+  PyObject** frame = &(*self->frames)[shm_name];
+  try {
+    endpoint = &GetEndpoint(self, topic_name, shm_name, type, ocm::ShmRole::SUBSCRIBER);
+    notifier = &GetNotifier(self, topic_name);
+  } catch (const std::exception& e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return nullptr;
+  }
+  bool success = RunWithoutGil([&](GilRelease& gil) {
+    size_t count = 0;
+    do {
+      if (mode == WaitMode::BLOCK) {
+        endpoint->Wait(*notifier);
+      } else if (mode == WaitMode::NO_WAIT ? !endpoint->TryWait(*notifier) : !endpoint->WaitTimeout(*notifier, ToMilliseconds(timeout))) {
+        return;
+      }
+      const bool view = mapped && !endpoint->IsViewRetried();
+      auto reader = [&](const uint8_t* data, size_t size) {
+        gil.Acquire();
+        bool delivered = view ? DeliverMapped(reinterpret_cast<PyObject*>(self), data, size, deliver) : DeliverFrame(*frame, data, size, deliver);
+        gil.Release();
+        if (!delivered) {
+          throw PythonError{};
+        }
+      };
+      count = view ? endpoint->View(reader) : endpoint->Snapshot(reader);
+    } while (mode == WaitMode::BLOCK && count == 0);
+  });
+  if (!success) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+/**
+ * @brief 以 `lcm_type.decode` 解码消息后调用回调。
+ *
+ * @param args Python 参数：`topic_name`、`shm_name`、`callback`、`lcm_type`，超时等待时另有 `timeout`。
+ * @param mode 等待方式。
+ * @return 成功时返回 `None`；失败时返回空并设置 Python 异常。
+ */
+PyObject* SubscribeDecoded(TopicObject* self, PyObject* args, WaitMode mode) {
+  const char* topic_name = nullptr;
+  const char* shm_name = nullptr;
+  PyObject* callback = nullptr;
+  PyObject* lcm_type = nullptr;
+  double timeout = 0.0;
+  if (!(mode == WaitMode::TIMEOUT ? PyArg_ParseTuple(args, "ssOOd", &topic_name, &shm_name, &callback, &lcm_type, &timeout)
+                                  : PyArg_ParseTuple(args, "ssOO", &topic_name, &shm_name, &callback, &lcm_type))) {
+    return nullptr;
+  }
+  return Receive(self, topic_name, shm_name, lcm_type, mode, timeout, false, [&](PyObject* view) -> PyObject* {
+    PyObject* msg = PyObject_CallMethod(lcm_type, "decode", "O", view);
+    if (!msg) {
+      return nullptr;
+    }
+    PyObject* result = PyObject_CallFunctionObjArgs(callback, msg, nullptr);
+    Py_DECREF(msg);
+    return result;
+  });
+}
+
+/**
+ * @brief 以消息的 `memoryview` 调用回调。
+ *
+ * 视图直接映射共享内存，只在回调内有效；顺序锁模式和环形布局下为消息的拷贝。
+ *
+ * @param args Python 参数：`topic_name`、`shm_name`、`callback`，超时等待时另有 `timeout`。
+ * @param mode 等待方式。
+ * @return 成功时返回 `None`；失败时返回空并设置 Python 异常。
+ */
+PyObject* SubscribeFrame(TopicObject* self, PyObject* args, WaitMode mode) {
+  const char* topic_name = nullptr;
+  const char* shm_name = nullptr;
+  PyObject* callback = nullptr;
+  double timeout = 0.0;
+  if (!(mode == WaitMode::TIMEOUT ? PyArg_ParseTuple(args, "ssOd", &topic_name, &shm_name, &callback, &timeout)
+                                  : PyArg_ParseTuple(args, "ssO", &topic_name, &shm_name, &callback))) {
+    return nullptr;
+  }
+  return Receive(self, topic_name, shm_name, nullptr, mode, timeout, true,
+                 [&](PyObject* view) -> PyObject* { return PyObject_CallFunctionObjArgs(callback, view, nullptr); });
+}
+
+/**
+ * @brief 编码消息并写入共享内存段，随后通知各个主题。
+ *
+ * 编码时持有 GIL，写入和通知期间释放 GIL。
+ *
+ * @param self 话题对象。
+ * @param topic_names 要通知的主题名。
+ * @param shm_name 共享内存段的名称。
+ * @param data 支持 `encode` 方法的消息。
+ * @return 成功时返回 `None`；失败时返回空并设置 Python 异常。
+ */
+PyObject* PublishEncoded(TopicObject* self, const std::vector<std::string>& topic_names, const char* shm_name, PyObject* data) {
+  PyObject* encoded = PyObject_CallMethod(data, "encode", nullptr);
+  if (!encoded) {
+    return nullptr;
+  }
+  Py_buffer buffer;
+  if (PyObject_GetBuffer(encoded, &buffer, PyBUF_SIMPLE) != 0) {
+    Py_DECREF(encoded);
+    return nullptr;
+  }
+  ocm::SharedMemoryEndpoint* endpoint = nullptr;
+  std::vector<ocm::SharedMemoryNotifier*> notifiers;
+  bool success = true;
+  try {
+    const std::string first_topic = topic_names.empty() ? std::string(shm_name) : topic_names.front();
+    endpoint = &GetEndpoint(self, first_topic, shm_name, reinterpret_cast<PyObject*>(Py_TYPE(data)), ocm::ShmRole::PUBLISHER);
+    for (const auto& topic_name : topic_names) {
+      notifiers.push_back(&GetNotifier(self, topic_name));
+    }
+  } catch (const std::exception& e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    success = false;
+  }
+  success = success && RunWithoutGil([&](GilRelease&) {
+              endpoint->Write(static_cast<size_t>(buffer.len), [&](uint8_t* dst) { memcpy(dst, buffer.buf, static_cast<size_t>(buffer.len)); });
+              for (auto* notifier : notifiers) {
+                notifier->Notify();
+              }
+            });
+  PyBuffer_Release(&buffer);
+  Py_DECREF(encoded);
+  if (!success) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+int TopicInit(TopicObject* self, PyObject* args, PyObject* kwargs) {
+  static const char* keywords[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", const_cast<char**>(keywords))) {
+    return -1;
+  }
+  if (!self->endpoints) {
+    self->endpoints = new std::unordered_map<std::string, std::unique_ptr<ocm::SharedMemoryEndpoint>>();
+    self->notifiers = new std::unordered_map<std::string, std::unique_ptr<ocm::SharedMemoryNotifier>>();
+    self->frames = new std::unordered_map<std::string, PyObject*>();
+  }
+  return 0;
+}
+
+void TopicDealloc(TopicObject* self) {
+  if (self->frames) {
+    for (auto& [shm_name, frame] : *self->frames) {
+      Py_XDECREF(frame);
+    }
+  }
+  delete self->frames;
+  delete self->notifiers;
+  delete self->endpoints;
+  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+/**
+ * @brief 检查话题对象已初始化。
+ *
+ * @param self 话题对象。
+ * @return 已初始化时返回 `true`；否则返回 `false` 并设置 Python 异常。
+ */
+bool CheckTopic(TopicObject* self) {
+  if (!self->endpoints) {
+    PyErr_SetString(PyExc_RuntimeError, "[SharedMemoryTopic] Object is not initialized");
+    return false;
+  }
+  return true;
+}
+
+PyObject* TopicPublish(TopicObject* self, PyObject* args) {
+  const char* topic_name = nullptr;
+  const char* shm_name = nullptr;
+  PyObject* data = nullptr;
+  if (!CheckTopic(self) || !PyArg_ParseTuple(args, "ssO", &topic_name, &shm_name, &data)) {
+    return nullptr;
+  }
+  return PublishEncoded(self, {topic_name}, shm_name, data);
+}
+
+PyObject* TopicPublishList(TopicObject* self, PyObject* args) {
+  PyObject* topic_list = nullptr;
+  const char* shm_name = nullptr;
+  PyObject* data = nullptr;
+  if (!CheckTopic(self) || !PyArg_ParseTuple(args, "OsO", &topic_list, &shm_name, &data)) {
+    return nullptr;
+  }
+  PyObject* topics = PySequence_Fast(topic_list, "topic_names must be a sequence");
+  if (!topics) {
+    return nullptr;
+  }
+  std::vector<std::string> topic_names;
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(topics); ++i) {
+    const char* topic_name = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(topics, i));
+    if (!topic_name) {
+      Py_DECREF(topics);
+      return nullptr;
+    }
+    topic_names.emplace_back(topic_name);
+  }
+  Py_DECREF(topics);
+  return PublishEncoded(self, topic_names, shm_name, data);
+}
+
+PyObject* TopicSubscribe(TopicObject* self, PyObject* args) { return CheckTopic(self) ? SubscribeDecoded(self, args, WaitMode::BLOCK) : nullptr; }
+
+PyObject* TopicSubscribeNoWait(TopicObject* self, PyObject* args) {
+  return CheckTopic(self) ? SubscribeDecoded(self, args, WaitMode::NO_WAIT) : nullptr;
+}
+
+PyObject* TopicSubscribeTimeout(TopicObject* self, PyObject* args) {
+  return CheckTopic(self) ? SubscribeDecoded(self, args, WaitMode::TIMEOUT) : nullptr;
+}
+
+PyObject* TopicSubscribeView(TopicObject* self, PyObject* args) { return CheckTopic(self) ? SubscribeFrame(self, args, WaitMode::BLOCK) : nullptr; }
+
+PyObject* TopicSubscribeViewNoWait(TopicObject* self, PyObject* args) {
+  return CheckTopic(self) ? SubscribeFrame(self, args, WaitMode::NO_WAIT) : nullptr;
+}
+
+PyObject* TopicSubscribeViewTimeout(TopicObject* self, PyObject* args) {
+  return CheckTopic(self) ? SubscribeFrame(self, args, WaitMode::TIMEOUT) : nullptr;
+}
+
+PyMethodDef topic_methods[] = {
+    {"Publish", reinterpret_cast<PyCFunction>(TopicPublish), METH_VARARGS, "Publish(topic_name, shm_name, data)：编码并发布消息。"},
+    {"PublishList", reinterpret_cast<PyCFunction>(TopicPublishList), METH_VARARGS,
+     "PublishList(topic_names, shm_name, data)：编码并发布消息，通知多个主题。"},
+    {"Subscribe", reinterpret_cast<PyCFunction>(TopicSubscribe), METH_VARARGS,
+     "Subscribe(topic_name, shm_name, callback, lcm_type)：阻塞等待并解码消息，等待期间释放 GIL。"},
+    {"SubscribeNoWait", reinterpret_cast<PyCFunction>(TopicSubscribeNoWait), METH_VARARGS,
+     "SubscribeNoWait(topic_name, shm_name, callback, lcm_type)：不阻塞地尝试接收并解码消息。"},
+    {"SubscribeTimeout", reinterpret_cast<PyCFunction>(TopicSubscribeTimeout), METH_VARARGS,
+     "SubscribeTimeout(topic_name, shm_name, callback, lcm_type, timeout)：在 timeout 秒内等待并解码消息，等待期间释放 GIL。"},
+    {"SubscribeView", reinterpret_cast<PyCFunction>(TopicSubscribeView), METH_VARARGS,
+     "SubscribeView(topic_name, shm_name, callback)：阻塞等待消息，以直接映射共享内存的 memoryview 调用回调，视图只在回调内有效。"
+     "锁模式下回调期间持有共享内存段的锁，发布者在回调返回前被阻塞。"},
+    {"SubscribeViewNoWait", reinterpret_cast<PyCFunction>(TopicSubscribeViewNoWait), METH_VARARGS,
+     "SubscribeViewNoWait(topic_name, shm_name, callback)：不阻塞地尝试接收消息。"},
+    {"SubscribeViewTimeout", reinterpret_cast<PyCFunction>(TopicSubscribeViewTimeout), METH_VARARGS,
+     "SubscribeViewTimeout(topic_name, shm_name, callback, timeout)：在 timeout 秒内等待消息。"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+PyTypeObject topic_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+PyModuleDef native_module = {PyModuleDef_HEAD_INIT, "_native", "共享内存话题的原生实现。", -1, nullptr, nullptr, nullptr, nullptr, nullptr};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit__native() {
+  semaphore_type.tp_name = "shared_memory_topic._native.SharedMemorySemaphore";
+  semaphore_type.tp_doc = "命名 POSIX 信号量。";
+  semaphore_type.tp_basicsize = sizeof(SemaphoreObject);
+  semaphore_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  semaphore_type.tp_new = PyType_GenericNew;
+  semaphore_type.tp_init = reinterpret_cast<initproc>(SemaphoreInit);
+  semaphore_type.tp_dealloc = reinterpret_cast<destructor>(SemaphoreDealloc);
+  semaphore_type.tp_methods = semaphore_methods;
+
+  topic_type.tp_name = "shared_memory_topic._native.SharedMemoryTopic";
+  topic_type.tp_doc = "共享内存话题，收发与 C++ 客户端共用端点和通知器实现。";
+  topic_type.tp_basicsize = sizeof(TopicObject);
+  topic_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  topic_type.tp_new = PyType_GenericNew;
+  topic_type.tp_init = reinterpret_cast<initproc>(TopicInit);
+  topic_type.tp_dealloc = reinterpret_cast<destructor>(TopicDealloc);
+  topic_type.tp_methods = topic_methods;
+
+  mapped_type.tp_name = "shared_memory_topic._native.MappedMessage";
+  mapped_type.tp_doc = "共享内存中一条消息的只读缓冲区。";
+  mapped_type.tp_basicsize = sizeof(MappedObject);
+  mapped_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  mapped_type.tp_dealloc = reinterpret_cast<destructor>(MappedDealloc);
+  mapped_type.tp_as_buffer = &mapped_buffer;
+
+  if (PyType_Ready(&semaphore_type) < 0 || PyType_Ready(&topic_type) < 0 || PyType_Ready(&mapped_type) < 0) {
+    return nullptr;
+  }
+  PyObject* module = PyModule_Create(&native_module);
+  if (!module) {
+    return nullptr;
+  }
+  Py_INCREF(&semaphore_type);
+  Py_INCREF(&topic_type);
+  if (PyModule_AddObject(module, "SharedMemorySemaphore", reinterpret_cast<PyObject*>(&semaphore_type)) < 0 ||
+      PyModule_AddObject(module, "SharedMemoryTopic", reinterpret_cast<PyObject*>(&topic_type)) < 0) {
+    Py_DECREF(&semaphore_type);
+    Py_DECREF(&topic_type);
+    Py_DECREF(module);
+    return nullptr;
+  }
+  return module;
+}
@@ -23,11 +23,10 @@ Executer::Executer(const ExecuterConfig& executer_config, const std::shared_ptr<
       task_stop_flag_(true),
       task_start_flag_(true),
       all_current_task_stop_(false),
-      desired_group_topic_name_(desired_group_topic_name) {
-  logger_ = GetLogger();                                                // 获取日志记录器
-  desired_group_topic_lcm_ = std::make_shared<SharedMemoryTopicLcm>();  // 创建共享内存主题
-  SetPeriod(executer_config_.executer_setting.timer_setting.period);    // 设置周期
-  TaskStart(executer_config_.executer_setting.system_setting);          // 启动任务
+      desired_group_subscriber_(desired_group_topic_name + "_lcm", desired_group_topic_name + "_lcm") {
+  logger_ = GetLogger();                                              // 获取日志记录器
+  SetPeriod(executer_config_.executer_setting.timer_setting.period);  // 设置周期
+  TaskStart(executer_config_.executer_setting.system_setting);        // 启动任务
 }
 
 void Executer::ExitAllTask() {
@@ -126,8 +125,7 @@ void Executer::InitTask() {
 
 void Executer::Run() {
   // 订阅期望组数据
-  desired_group_topic_lcm_->SubscribeNoWait<DesiredGroupData>(
-      desired_group_topic_name_ + "_lcm", desired_group_topic_name_ + "_lcm",
+  desired_group_subscriber_.SubscribeNoWait(
       [this](const DesiredGroupData& desired_group) { desired_group_ = desired_group.desired_group; });  // 更新期望组
   TransitionCheck();                                                                                     // 检查状态转换
 
@@ -1,16 +1,27 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <linux/futex.h>
 #include <semaphore.h>
+#include <signal.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <climits>
 #include <cstring>
 #include <ctime>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 #include "common/prefix_string.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "ocm/shared_memory_registry.hpp"
 #include "ocm/shared_memory_semaphore.hpp"
+#include "ocm/shared_memory_wait_set.hpp"
 
 namespace ocm {
 
@@ -73,7 +84,7 @@ bool SharedMemorySemaphore::DecrementTimeout(uint64_t milliseconds) {
   ts.tv_sec += ts.tv_nsec / 1000000000;           // 处理秒和纳秒的进位
   ts.tv_nsec %= 1000000000;                       // 确保纳秒在有效范围内
 
-  return (sem_timedwait(sem_, &ts) == 0);  // 尝试在超时内减少信号量
+  return (sem_clockwait(sem_, CLOCK_MONOTONIC, &ts) == 0);  // 尝试在超时内减少信号量
 }
 
 int SharedMemorySemaphore::GetValue() const {
@@ -97,4 +108,600 @@ void SharedMemorySemaphore::Destroy() {
 
 SharedMemorySemaphore::~SharedMemorySemaphore() = default;
 
+SharedMemoryNotifier::SharedMemoryNotifier(const std::string& name, ShmNotifyMode mode) : mode_(mode) {
+  if (mode_ == ShmNotifyMode::SEMAPHORE) {
+    sem_ = std::make_shared<SharedMemorySemaphore>(name, 0);  // 兼容模式使用命名信号量
+    return;
+  }
+  name_ = GetNamePrefix(name + "_notify");                                                              // 获取通知段名称
+  int fd = shm_open(name_.c_str(), O_RDWR | O_CREAT, S_IWUSR | S_IRUSR | S_IWGRP | S_IRGRP | S_IROTH);  // 打开或创建通知段
+  if (fd < 0) {
+    throw std::runtime_error("[SharedMemoryNotifier] shm_open failed for \"" + name + "\": " + std::string(strerror(errno)));  // 抛出异常
+  }
+  // 所有打开者都扩展到相同大小，扩展只补零，不会破坏已有状态
+  if (ftruncate(fd, sizeof(SharedMemoryNotifyState)) != 0) {
+    close(fd);
+    throw std::runtime_error("[SharedMemoryNotifier] ftruncate failed for \"" + name + "\": " + std::string(strerror(errno)));  // 抛出异常
+  }
+  void* addr = mmap(nullptr, sizeof(SharedMemoryNotifyState), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);  // 映射通知段
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("[SharedMemoryNotifier] mmap failed for \"" + name + "\": " + std::string(strerror(errno)));  // 抛出异常
+  }
+  state_ = static_cast<SharedMemoryNotifyState*>(addr);
+}
+
+SharedMemoryNotifier::~SharedMemoryNotifier() {
+  if (state_ != nullptr) {
+    munmap(state_, sizeof(SharedMemoryNotifyState));  // 解除通知段映射
+  }
+}
+
+void SharedMemoryNotifier::Notify() {
+  if (sem_) {
+    sem_->IncrementWhenZero();
+    return;
+  }
+  uint32_t generation = state_->generation.fetch_add(1, std::memory_order_seq_cst);  // 发布新的通知代数
+  state_->set_generation.fetch_add(1, std::memory_order_seq_cst);                    // 同步等待集的通知代数
+  if (state_->waiters.load(std::memory_order_seq_cst) != 0) {                        // 仅在有订阅者等待时进入内核
+    // 一次系统调用唤醒该位掩码上的所有等待者，每个订阅者的唤醒不依赖其他订阅者被调度
+    if (Wake(generation, INT_MAX) < 0) {
+      throw std::runtime_error("[SharedMemoryNotifier] Failed to wake waiters: " + std::string(strerror(errno)));  // 抛出异常
+    }
+  }
+  if (state_->set_waiters.load(std::memory_order_seq_cst) != 0) {  // 等待集等待多个 futex 字，无法逐级唤醒，全部唤醒
+    if (syscall(SYS_futex, &state_->set_generation, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0) < 0) {
+      throw std::runtime_error("[SharedMemoryNotifier] Failed to wake wait sets: " + std::string(strerror(errno)));  // 抛出异常
+    }
+  }
+}
+
+long SharedMemoryNotifier::Wake(uint32_t generation, int count) {
+  return syscall(SYS_futex, &state_->generation, FUTEX_WAKE_BITSET, count, nullptr, nullptr, GetWaitBit(generation));
+}
+
+void SharedMemoryNotifier::Wait() {
+  if (sem_) {
+    sem_->Decrement();
+    return;
+  }
+  WaitUntil(nullptr);
+}
+
+bool SharedMemoryNotifier::TryWait() {
+  if (sem_) {
+    return sem_->TryDecrement();
+  }
+  uint32_t generation = state_->generation.load(std::memory_order_acquire);  // 读取当前通知代数
+  if (generation - seen_ < decimation_) {
+    return false;
+  }
+  seen_ = generation;
+  state_->consumed.store(generation, std::memory_order_release);  // 供发布者判断通知已被处理
+  return true;
+}
+
+bool SharedMemoryNotifier::IsPending() const {
+  if (sem_) {
+    return sem_->GetValue() > 0;
+  }
+  return state_->generation.load(std::memory_order_acquire) - seen_ >= decimation_;
+}
+
+bool SharedMemoryNotifier::IsConsumed() const {
+  if (sem_) {
+    return sem_->GetValue() == 0;
+  }
+  return state_->consumed.load(std::memory_order_acquire) == state_->generation.load(std::memory_order_acquire);
+}
+
+bool SharedMemoryNotifier::WaitTimeout(uint64_t milliseconds) {
+  if (sem_) {
+    return sem_->DecrementTimeout(milliseconds);
+  }
+  struct timespec deadline;                                                                                          // 定义截止时间
+  if (clock_gettime(CLOCK_MONOTONIC, &deadline) != 0) {                                                              // 获取当前时间
+    throw std::runtime_error("[SharedMemoryNotifier] Failed to get current time: " + std::string(strerror(errno)));  // 抛出异常
+  }
+  deadline.tv_sec += milliseconds / 1000;               // 增加秒数
+  deadline.tv_nsec += (milliseconds % 1000) * 1000000;  // 增加纳秒数
+  deadline.tv_sec += deadline.tv_nsec / 1000000000;     // 处理秒和纳秒的进位
+  deadline.tv_nsec %= 1000000000;                       // 确保纳秒在有效范围内
+  return WaitUntil(&deadline);
+}
+
+bool SharedMemoryNotifier::WaitUntil(const struct timespec* deadline) {
+  if (TryWait()) {
+    return true;
+  }
+  // 先登记等待者再检查代数，与 Notify 中先加代数再检查等待者配对，避免丢失唤醒
+  state_->waiters.fetch_add(1, std::memory_order_seq_cst);
+  bool notified = true;
+  // 抽取时等待第 decimation_ 次通知：只有代数从 target 前进时发布者才唤醒该位掩码上的等待者
+  const uint32_t target = seen_ + decimation_ - 1;
+  uint32_t generation;
+  while ((generation = state_->generation.load(std::memory_order_seq_cst)) - seen_ < decimation_) {
+    // FUTEX_WAIT_BITSET 的超时为 CLOCK_MONOTONIC 下的绝对时间，被信号打断或虚假唤醒后无需重新计算
+    // 位掩码冲突造成的虚假唤醒后代数未达到目标，继续等待
+    if (syscall(SYS_futex, &state_->generation, FUTEX_WAIT_BITSET, generation, deadline, nullptr, GetWaitBit(target)) != 0) {
+      if (errno == ETIMEDOUT) {
+        notified = false;
+        break;
+      }
+      if (errno != EAGAIN && errno != EINTR) {
+        state_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+        throw std::runtime_error("[SharedMemoryNotifier] Failed to wait for notification: " + std::string(strerror(errno)));  // 抛出异常
+      }
+    }
+  }
+  state_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+  return notified && TryWait();
+}
+
+void SharedMemoryNotifier::Destroy() {
+  if (sem_) {
+    sem_->Destroy();
+    return;
+  }
+  if (shm_unlink(name_.c_str()) != 0 && errno != ENOENT) {                                                          // 尝试删除通知段
+    throw std::runtime_error("[SharedMemoryNotifier] Failed to unlink notifier: " + std::string(strerror(errno)));  // 抛出异常
+  }
+}
+
+namespace {
+
+/**
+ * @brief 获取 `CLOCK_MONOTONIC` 下的当前时刻（纳秒）。
+ */
+uint64_t GetMonotonicNanoseconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * @brief 将字符串截断复制到定长字符数组。
+ */
+void CopyName(char (&dst)[SHM_REGISTRY_NAME_SIZE], const std::string& src) {
+  size_t size = std::min(src.size(), SHM_REGISTRY_NAME_SIZE - 1);
+  memcpy(dst, src.data(), size);
+  dst[size] = '\0';
+}
+
+/**
+ * @brief 判断进程是否仍在运行。
+ */
+bool IsProcessAlive(int32_t pid) { return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM); }
+
+/**
+ * @brief 获取角色对应的进程号数组。
+ */
+std::atomic<int32_t>* GetPids(SharedMemoryRegistryEntry& entry, ShmRole role) {
+  return role == ShmRole::PUBLISHER ? entry.publisher_pids : entry.subscriber_pids;
+}
+
+}  // namespace
+
+SharedMemoryRegistry& SharedMemoryRegistry::getInstance() {
+  static SharedMemoryRegistry instance;  // 首次使用时创建或打开注册表段
+  return instance;
+}
+
+SharedMemoryRegistry::SharedMemoryRegistry() {
+  const auto name = GetNamePrefix("registry");
+  const size_t size = sizeof(SharedMemoryRegistryHeader) + sizeof(SharedMemoryRegistryEntry) * SHM_REGISTRY_CAPACITY;
+  const mode_t mode = S_IWUSR | S_IRUSR | S_IWGRP | S_IRGRP | S_IROTH;  // 与共享内存段相同，其他用户不可写
+  bool is_create = true;
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, mode);  // 只有一个进程负责初始化
+  if (fd < 0 && errno == EEXIST) {
+    is_create = false;
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+  }
+  if (fd < 0) {
+    return;  // 注册表不可用时话题照常收发
+  }
+  // 所有打开者都扩展到相同大小，扩展只补零，不会破坏已有状态
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    return;
+  }
+  void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return;
+  }
+  auto* header = static_cast<SharedMemoryRegistryHeader*>(addr);
+  if (is_create) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    int ret = pthread_mutex_init(&header->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (ret != 0) {
+      munmap(addr, size);
+      return;
+    }
+    header->version = SHM_REGISTRY_VERSION;
+    header->capacity = SHM_REGISTRY_CAPACITY;
+    header->magic.store(SHM_REGISTRY_MAGIC, std::memory_order_release);
+  } else {
+    // 等待创建者完成初始化，创建者中途退出时放弃
+    for (int i = 0; i < 100 && header->magic.load(std::memory_order_acquire) != SHM_REGISTRY_MAGIC; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (header->magic.load(std::memory_order_acquire) != SHM_REGISTRY_MAGIC || header->version != SHM_REGISTRY_VERSION ||
+        header->capacity != SHM_REGISTRY_CAPACITY) {
+      munmap(addr, size);
+      return;
+    }
+  }
+  header_ = header;
+  entries_ = reinterpret_cast<SharedMemoryRegistryEntry*>(header + 1);
+}
+
+bool SharedMemoryRegistry::Lock() const {
+  int ret = pthread_mutex_lock(&header_->mutex);
+  if (ret == EOWNERDEAD) {
+    // 条目在填写完成后才标记为已占用，持锁进程中途退出不会留下半写的条目
+    ret = pthread_mutex_consistent(&header_->mutex);
+  }
+  return ret == 0;
+}
+
+void SharedMemoryRegistry::UnLock() const { pthread_mutex_unlock(&header_->mutex); }
+
+int SharedMemoryRegistry::Register(const std::string& topic_name, const std::string& shm_name, const std::string& type_name, int64_t type_hash,
+                                   const SharedMemoryOption& option) {
+  if (!header_ || !Lock()) {
+    return -1;
+  }
+  int index = -1;
+  int free_index = -1;
+  for (uint32_t i = 0; i < SHM_REGISTRY_CAPACITY; ++i) {
+    auto& entry = entries_[i];
+    if (!entry.used.load(std::memory_order_acquire)) {
+      if (free_index < 0) {
+        free_index = static_cast<int>(i);
+      }
+    } else if (strncmp(entry.topic_name, topic_name.c_str(), SHM_REGISTRY_NAME_SIZE) == 0 &&
+               strncmp(entry.shm_name, shm_name.c_str(), SHM_REGISTRY_NAME_SIZE) == 0) {
+      index = static_cast<int>(i);
+      break;
+    }
+  }
+  if (index < 0 && free_index >= 0) {
+    index = free_index;
+    auto& entry = entries_[index];
+    CopyName(entry.topic_name, topic_name);
+    CopyName(entry.shm_name, shm_name);
+    CopyName(entry.type_name, type_name);
+    entry.type_hash = type_hash;
+    entry.lock_mode = static_cast<uint8_t>(option.lock_mode);
+    entry.layout = static_cast<uint8_t>(option.layout);
+    entry.notify_mode = static_cast<uint8_t>(option.notify_mode);
+    entry.slot_count = option.slot_count;
+    entry.capacity = option.capacity;
+    entry.create_time = GetMonotonicNanoseconds();
+    for (size_t i = 0; i < SHM_REGISTRY_PID_COUNT; ++i) {
+      entry.publisher_pids[i].store(0, std::memory_order_relaxed);
+      entry.subscriber_pids[i].store(0, std::memory_order_relaxed);
+    }
+    entry.publish_count.store(0, std::memory_order_relaxed);
+    entry.last_publish_time.store(0, std::memory_order_relaxed);
+    entry.publish_interval.store(0, std::memory_order_relaxed);
+    entry.overflow_count.store(0, std::memory_order_relaxed);
+    entry.used.store(1, std::memory_order_release);
+  }
+  UnLock();
+  return index;
+}
+
+void SharedMemoryRegistry::Update(int index, const SharedMemoryOption& option) {
+  if (!Lock()) {
+    return;
+  }
+  auto& entry = entries_[index];
+  entry.lock_mode = static_cast<uint8_t>(option.lock_mode);
+  entry.layout = static_cast<uint8_t>(option.layout);
+  entry.slot_count = option.slot_count;
+  entry.capacity = option.capacity;
+  UnLock();
+}
+
+int SharedMemoryRegistry::AddProcess(int index, ShmRole role) {
+  auto* pids = GetPids(entries_[index], role);
+  const int32_t pid = getpid();
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < SHM_REGISTRY_PID_COUNT; ++i) {
+      int32_t current = pids[i].load(std::memory_order_relaxed);
+      // 第一轮只占用空闲位置，第二轮占用已退出进程留下的位置
+      if ((pass == 0 ? current == 0 : !IsProcessAlive(current)) && pids[i].compare_exchange_strong(current, pid, std::memory_order_relaxed)) {
+        return static_cast<int>(i);
+      }
+    }
+  }
+  // 进程号表已满时只计数，回收时仍视为有进程在使用
+  entries_[index].overflow_count.fetch_add(1, std::memory_order_relaxed);
+  return -1;
+}
+
+void SharedMemoryRegistry::RemoveProcess(int index, ShmRole role, int slot) {
+  if (slot < 0) {
+    entries_[index].overflow_count.fetch_sub(1, std::memory_order_relaxed);
+    return;
+  }
+  int32_t pid = getpid();
+  GetPids(entries_[index], role)[slot].compare_exchange_strong(pid, 0, std::memory_order_relaxed);
+}
+
+SharedMemoryTopicInfo SharedMemoryRegistry::MakeInfo(const SharedMemoryRegistryEntry& entry) {
+  SharedMemoryTopicInfo info;
+  info.topic_name = std::string(entry.topic_name, strnlen(entry.topic_name, SHM_REGISTRY_NAME_SIZE));
+  info.shm_name = std::string(entry.shm_name, strnlen(entry.shm_name, SHM_REGISTRY_NAME_SIZE));
+  info.type_name = std::string(entry.type_name, strnlen(entry.type_name, SHM_REGISTRY_NAME_SIZE));
+  info.type_hash = entry.type_hash;
+  info.option.lock_mode = static_cast<ShmLockMode>(entry.lock_mode);
+  info.option.layout = static_cast<ShmLayout>(entry.layout);
+  info.option.notify_mode = static_cast<ShmNotifyMode>(entry.notify_mode);
+  info.option.slot_count = entry.slot_count;
+  info.option.capacity = entry.capacity;
+  for (size_t i = 0; i < SHM_REGISTRY_PID_COUNT; ++i) {
+    int32_t pid = entry.publisher_pids[i].load(std::memory_order_relaxed);
+    if (IsProcessAlive(pid)) {
+      info.publisher_pids.push_back(pid);
+    }
+    info.subscriber_count += IsProcessAlive(entry.subscriber_pids[i].load(std::memory_order_relaxed)) ? 1 : 0;
+  }
+  info.publish_count = entry.publish_count.load(std::memory_order_relaxed);
+  info.last_publish_time = entry.last_publish_time.load(std::memory_order_relaxed);
+  uint64_t interval = entry.publish_interval.load(std::memory_order_relaxed);
+  info.publish_rate = interval == 0 ? 0.0 : 1e9 / static_cast<double>(interval);
+  return info;
+}
+
+std::vector<SharedMemoryTopicInfo> SharedMemoryRegistry::List() const {
+  std::vector<SharedMemoryTopicInfo> infos;
+  if (!header_ || !Lock()) {
+    return infos;
+  }
+  for (uint32_t i = 0; i < SHM_REGISTRY_CAPACITY; ++i) {
+    if (entries_[i].used.load(std::memory_order_acquire)) {
+      infos.push_back(MakeInfo(entries_[i]));
+    }
+  }
+  UnLock();
+  return infos;
+}
+
+bool SharedMemoryRegistry::Find(const std::string& topic_name, SharedMemoryTopicInfo* info) const {
+  for (auto& found : List()) {
+    if (found.topic_name == topic_name) {
+      *info = std::move(found);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::string> SharedMemoryRegistry::Reclaim(uint64_t idle_nanoseconds) {
+  std::vector<std::string> reclaimed;
+  if (!header_ || !Lock()) {
+    return reclaimed;
+  }
+  const uint64_t now = GetMonotonicNanoseconds();
+  std::vector<SharedMemoryTopicInfo> infos;
+  for (uint32_t i = 0; i < SHM_REGISTRY_CAPACITY; ++i) {
+    auto& entry = entries_[i];
+    if (!entry.used.load(std::memory_order_acquire)) {
+      continue;
+    }
+    auto info = MakeInfo(entry);
+    uint64_t last_active = std::max(info.last_publish_time, entry.create_time);
+    if (!info.publisher_pids.empty() || info.subscriber_count != 0 || entry.overflow_count.load(std::memory_order_relaxed) != 0 ||
+        now - last_active < idle_nanoseconds) {
+      continue;
+    }
+    entry.used.store(0, std::memory_order_release);
+    infos.push_back(std::move(info));
+  }
+  // 多个话题可以共用一个共享内存段，一个主题也可以使用多个段，只删除不再被其他条目使用的段和通知器
+  auto in_use = [this](const std::string& name, bool topic) {
+    for (uint32_t i = 0; i < SHM_REGISTRY_CAPACITY; ++i) {
+      const auto& entry = entries_[i];
+      if (entry.used.load(std::memory_order_acquire) &&
+          strncmp(topic ? entry.topic_name : entry.shm_name, name.c_str(), SHM_REGISTRY_NAME_SIZE) == 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (const auto& info : infos) {
+    if (!in_use(info.shm_name, false)) {
+      shm_unlink(GetNamePrefix(info.shm_name).c_str());                 // 删除共享内存段
+      unlink(("/dev/hugepages/" + GetNamePrefix(info.shm_name)).c_str());  // 删除 hugetlbfs 中的共享内存段
+      sem_unlink(GetNamePrefix(info.shm_name + "_shm").c_str());        // 删除共享内存段的信号量
+    }
+    if (!in_use(info.topic_name, true)) {
+      sem_unlink(GetNamePrefix(info.topic_name).c_str());              // 删除主题的通知信号量
+      shm_unlink(GetNamePrefix(info.topic_name + "_notify").c_str());  // 删除主题的通知段
+    }
+    reclaimed.push_back(info.topic_name);
+  }
+  UnLock();
+  return reclaimed;
+}
+
+void SharedMemoryRegistry::Destroy() {
+  if (shm_unlink(GetNamePrefix("registry").c_str()) != 0 && errno != ENOENT) {
+    throw std::runtime_error("[SharedMemoryRegistry] Failed to unlink registry: " + std::string(strerror(errno)));  // 抛出异常
+  }
+}
+
+SharedMemoryRegistration::~SharedMemoryRegistration() {
+  if (pending_count_ != 0) {
+    FlushPublish(last_publish_);
+  }
+  for (auto role : {ShmRole::PUBLISHER, ShmRole::SUBSCRIBER}) {
+    int slot = slots_[static_cast<int>(role)];
+    if (slot >= 0 || overflowed_[static_cast<int>(role)]) {
+      SharedMemoryRegistry::getInstance().RemoveProcess(index_, role, slot);  // 注销本进程
+    }
+  }
+}
+
+bool SharedMemoryRegistration::Register(const std::string& topic_name, const std::string& shm_name, const std::string& type_name, int64_t type_hash,
+                                        const SharedMemoryOption& option, ShmRole role) {
+  auto role_index = static_cast<int>(role);
+  if (registered_[role_index]) {
+    return false;
+  }
+  registered_[role_index] = true;
+  auto& registry = SharedMemoryRegistry::getInstance();
+  if (index_ < 0) {
+    index_ = registry.Register(topic_name, shm_name, type_name, type_hash, option);
+  }
+  if (index_ >= 0) {
+    slots_[role_index] = registry.AddProcess(index_, role);
+    overflowed_[role_index] = slots_[role_index] < 0;
+  }
+  return index_ >= 0;
+}
+
+void SharedMemoryRegistration::Update(const SharedMemoryOption& option) {
+  if (index_ >= 0) {
+    SharedMemoryRegistry::getInstance().Update(index_, option);
+  }
+}
+
+size_t SharedMemoryWaitSet::Attach(SharedMemoryNotifier& notifier, SharedMemoryEndpoint* endpoint) {
+  Entry entry;
+  entry.notifier = &notifier;
+  entry.endpoint = endpoint;
+  entries_.push_back(entry);
+  // 预留每轮等待所需的容量，等待时不再分配内存
+  notifiers_.reserve(entries_.size());
+#ifdef SYS_futex_waitv
+  waiters_.reserve(entries_.size());
+#endif
+  return entries_.size() - 1;
+}
+
+size_t SharedMemoryWaitSet::AttachTimer(uint64_t period_nanoseconds) {
+  if (period_nanoseconds == 0) {
+    throw std::runtime_error("[SharedMemoryWaitSet] Timer period must be positive");  // 抛出异常
+  }
+  Entry entry;
+  entry.period = period_nanoseconds;
+  entry.next_time = SharedMemoryEndpoint::GetMonotonicTime() + period_nanoseconds;
+  entries_.push_back(entry);
+  return entries_.size() - 1;
+}
+
+const std::vector<size_t>& SharedMemoryWaitSet::Wait() {
+  if (entries_.empty()) {
+    throw std::runtime_error("[SharedMemoryWaitSet] Nothing to wait for");  // 抛出异常
+  }
+  return WaitUntil(0);
+}
+
+const std::vector<size_t>& SharedMemoryWaitSet::WaitTimeout(uint64_t milliseconds) {
+  return WaitUntil(SharedMemoryEndpoint::GetMonotonicTime() + milliseconds * 1000000);
+}
+
+const std::vector<size_t>& SharedMemoryWaitSet::WaitUntil(uint64_t deadline) {
+  while (true) {
+    const uint64_t now = SharedMemoryEndpoint::GetMonotonicTime();
+    uint64_t wake_time = deadline;
+    ready_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      auto& entry = entries_[i];
+      if (entry.notifier) {
+        // 限速的订阅者在允许交付之前即使有通知也不就绪，否则调用者取不到消息而反复空转
+        entry.held = entry.endpoint && !entry.endpoint->IsDeliveryDue();
+        if (entry.held) {
+          uint64_t due = entry.endpoint->GetNextDeliveryTime();
+          wake_time = wake_time == 0 ? due : std::min(wake_time, due);
+        } else if (entry.notifier->IsPending() || (entry.endpoint && entry.endpoint->HasUnread())) {
+          ready_.push_back(i);
+        }
+        continue;
+      }
+      if (now >= entry.next_time) {
+        ready_.push_back(i);
+        // 按周期对齐下一次就绪时刻，错过的周期不补发
+        entry.next_time += ((now - entry.next_time) / entry.period + 1) * entry.period;
+      }
+      wake_time = wake_time == 0 ? entry.next_time : std::min(wake_time, entry.next_time);
+    }
+    if (!ready_.empty() || (deadline != 0 && now >= deadline)) {
+      return ready_;
+    }
+    Block(wake_time);
+  }
+}
+
+void SharedMemoryWaitSet::Block(uint64_t wake_time) {
+  struct timespec deadline;
+  deadline.tv_sec = static_cast<time_t>(wake_time / 1000000000);
+  deadline.tv_nsec = static_cast<long>(wake_time % 1000000000);
+
+  notifiers_.clear();
+  bool use_waitv = waitv_supported_;
+  for (auto& entry : entries_) {
+    if (entry.notifier && !entry.held) {
+      notifiers_.push_back(entry.notifier);
+      use_waitv = use_waitv && entry.notifier->state_ != nullptr;  // 信号量通知无法用 futex 等待
+    }
+  }
+  if (notifiers_.empty()) {
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);  // 只有定时器和限速中的话题时直接睡眠到下一次就绪
+    return;
+  }
+#ifdef SYS_futex_waitv
+  if (use_waitv && notifiers_.size() <= FUTEX_WAITV_MAX) {
+    waiters_.resize(notifiers_.size());
+    // 先登记等待者再读取代数并复查通知，与 Notify 中先加代数再检查等待者配对，避免丢失唤醒
+    for (size_t i = 0; i < notifiers_.size(); ++i) {
+      auto* state = notifiers_[i]->state_;
+      state->set_waiters.fetch_add(1, std::memory_order_seq_cst);
+      waiters_[i] = {};
+      waiters_[i].val = state->set_generation.load(std::memory_order_seq_cst);
+      waiters_[i].uaddr = reinterpret_cast<uintptr_t>(&state->set_generation);
+      waiters_[i].flags = FUTEX_32;
+    }
+    bool pending = false;
+    for (auto* notifier : notifiers_) {
+      pending = pending || notifier->IsPending();
+    }
+    long ret = 0;
+    int error = 0;
+    if (!pending) {
+      ret = syscall(SYS_futex_waitv, waiters_.data(), static_cast<unsigned int>(waiters_.size()), 0, wake_time != 0 ? &deadline : nullptr,
+                    CLOCK_MONOTONIC);
+      error = errno;
+    }
+    for (auto* notifier : notifiers_) {
+      notifier->state_->set_waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    if (ret >= 0 || error == EAGAIN || error == ETIMEDOUT || error == EINTR) {
+      return;
+    }
+    if (error != ENOSYS) {
+      throw std::runtime_error("[SharedMemoryWaitSet] Failed to wait for notification: " + std::string(strerror(error)));  // 抛出异常
+    }
+    waitv_supported_ = false;  // 内核不支持 futex_waitv，之后改为轮询
+  }
+#endif
+  // 轮询方式：睡眠一个轮询间隔，但不超过唤醒时刻
+  uint64_t sleep_until = SharedMemoryEndpoint::GetMonotonicTime() + kPollInterval;
+  if (wake_time != 0) {
+    sleep_until = std::min(sleep_until, wake_time);
+  }
+  deadline.tv_sec = static_cast<time_t>(sleep_until / 1000000000);
+  deadline.tv_nsec = static_cast<long>(sleep_until % 1000000000);
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+}
+
 }  // namespace ocm
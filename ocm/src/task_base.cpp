@@ -30,10 +30,8 @@ void SleepInternalTimer::Continue() {
 
 SleepExternalTimer::SleepExternalTimer(const std::string& sem_name, const std::string& shm_name)
     : sem_(sem_name, 0), shm_(shm_name, false, sizeof(uint8_t)) {
-  shm_.Lock();               // 锁定共享内存
-  dt_ = *shm_.Get();         // 从共享内存中读取初始定时器增量
-  shm_.UnLock();             // 解锁共享内存
-  interval_count_.store(0);  // 初始化间隔计数
+  shm_.Read([this] { dt_ = *shm_.Get(); });  // 从共享内存中一致地读取初始定时器增量，支持信号量和顺序锁模式
+  interval_count_.store(0);                  // 初始化间隔计数
 }
 
 void SleepExternalTimer::Sleep(double duration) {
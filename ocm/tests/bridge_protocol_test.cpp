@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ocm/bridge_protocol.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+/**
+ * @brief 解析数据报中的所有记录。
+ */
+std::vector<std::string> ParseAll(const std::vector<uint8_t>& datagram, ocm::BridgeDatagramHeader* header, bool* complete) {
+  std::vector<std::string> payloads;
+  OCM_CHECK(ocm::ParseBridgeDatagramHeader(datagram.data(), datagram.size(), header));
+  *complete = ocm::ForEachBridgeRecord(datagram.data(), datagram.size(), [&](const ocm::BridgeRecord& record) {
+    OCM_CHECK(record.topic_name == "topic");
+    OCM_CHECK(record.shm_name == "shm");
+    OCM_CHECK(record.type_hash == 42);
+    payloads.emplace_back(reinterpret_cast<const char*>(record.data), record.size);
+  });
+  return payloads;
+}
+
+/**
+ * @brief 合并到数据报中的记录可原样解析，放不下时另起数据报，序号连续。
+ */
+void TestFraming() {
+  const size_t datagram_size = 128;
+  ocm::BridgeDatagramBuilder builder(datagram_size, 7);
+  const std::string topic = "topic", shm = "shm";
+  std::vector<std::string> sent;
+  for (int i = 0; i < 10; ++i) {
+    sent.push_back("payload-" + std::to_string(i));
+    OCM_CHECK(builder.Add(topic, shm, 42, reinterpret_cast<const uint8_t*>(sent.back().data()), sent.back().size()));
+  }
+  const auto& datagrams = builder.GetDatagrams();
+  OCM_CHECK(datagrams.size() > 1);
+  std::vector<std::string> received;
+  for (size_t i = 0; i < datagrams.size(); ++i) {
+    OCM_CHECK(datagrams[i].size() <= datagram_size);
+    ocm::BridgeDatagramHeader header;
+    bool complete = false;
+    auto payloads = ParseAll(datagrams[i], &header, &complete);
+    OCM_CHECK(complete);
+    OCM_CHECK(header.sender == 7);
+    OCM_CHECK(header.sequence == i);
+    OCM_CHECK(header.count == payloads.size());
+    received.insert(received.end(), payloads.begin(), payloads.end());
+  }
+  OCM_CHECK(received == sent);
+  const uint32_t next_sequence = static_cast<uint32_t>(datagrams.size());
+
+  // 超过数据报大小的记录单独成为一个数据报，超过 UDP 上限的记录被拒绝
+  builder.Clear();
+  std::vector<uint8_t> large(1000, 0xAB);
+  OCM_CHECK(builder.Add(topic, shm, 42, large.data(), large.size()));
+  OCM_CHECK(builder.GetDatagrams().size() == 1);
+  std::vector<uint8_t> oversize(ocm::BRIDGE_MAX_DATAGRAM_SIZE, 0);
+  OCM_CHECK(!builder.Add(topic, shm, 42, oversize.data(), oversize.size()));
+  ocm::BridgeDatagramHeader header;
+  bool complete = false;
+  auto payloads = ParseAll(builder.GetDatagrams()[0], &header, &complete);
+  OCM_CHECK(complete && payloads.size() == 1 && payloads[0].size() == large.size());
+  OCM_CHECK(header.sequence == next_sequence);
+}
+
+/**
+ * @brief 截断的数据报和错误的魔数被识别为格式错误，截断前的记录仍可读取。
+ */
+void TestMalformed() {
+  ocm::BridgeDatagramBuilder builder(1472, 1);
+  const std::string topic = "topic", shm = "shm", payload = "0123456789";
+  for (int i = 0; i < 2; ++i) {
+    OCM_CHECK(builder.Add(topic, shm, 42, reinterpret_cast<const uint8_t*>(payload.data()), payload.size()));
+  }
+  auto datagram = builder.GetDatagrams()[0];
+  ocm::BridgeDatagramHeader header;
+  OCM_CHECK(!ocm::ParseBridgeDatagramHeader(datagram.data(), sizeof(header) - 1, &header));
+
+  datagram.resize(datagram.size() - 1);
+  bool complete = true;
+  auto payloads = ParseAll(datagram, &header, &complete);
+  OCM_CHECK(!complete);
+  OCM_CHECK(payloads.size() == 1 && payloads[0] == payload);
+
+  datagram[0] ^= 0xFF;
+  OCM_CHECK(!ocm::ParseBridgeDatagramHeader(datagram.data(), datagram.size(), &header));
+}
+
+/**
+ * @brief 丢失、乱序和序号回绕的统计。
+ */
+void TestSequence() {
+  ocm::BridgeSequenceTracker tracker;
+  for (uint32_t sequence : {0U, 1U, 2U, 5U}) {
+    tracker.Track(1, sequence);
+  }
+  OCM_CHECK(tracker.GetLostCount() == 2);
+  OCM_CHECK(tracker.GetReorderedCount() == 0);
+
+  // 迟到的数据报不再计为丢失
+  tracker.Track(1, 3);
+  OCM_CHECK(tracker.GetLostCount() == 1);
+  OCM_CHECK(tracker.GetReorderedCount() == 1);
+  tracker.Track(1, 6);
+  OCM_CHECK(tracker.GetLostCount() == 1);
+
+  // 不同发送端的序号互不影响
+  tracker.Track(2, 100);
+  tracker.Track(2, 101);
+  OCM_CHECK(tracker.GetLostCount() == 1);
+
+  // 序号回绕不计为丢失或乱序
+  ocm::BridgeSequenceTracker wrap;
+  for (uint32_t sequence : {UINT32_MAX - 1, UINT32_MAX, 0U, 1U}) {
+    wrap.Track(3, sequence);
+  }
+  OCM_CHECK(wrap.GetLostCount() == 0);
+  OCM_CHECK(wrap.GetReorderedCount() == 0);
+  wrap.Track(3, 3);
+  OCM_CHECK(wrap.GetLostCount() == 1);
+}
+
+}  // namespace
+
+int main() {
+  TestFraming();
+  TestMalformed();
+  TestSequence();
+  printf("bridge_protocol_test passed\n");
+  return 0;
+}
@@ -0,0 +1,254 @@
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "ocm/lcm_log.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+/**
+ * @brief 录制的一个事件。
+ */
+struct Event {
+  std::string channel; /**< 频道名。 */
+  int64_t timestamp;   /**< 时间戳（微秒）。 */
+  std::string payload; /**< 事件数据。 */
+};
+
+/**
+ * @brief 以较小的写缓冲区写入日志，使事件跨多个缓冲区和多次预分配。
+ */
+void WriteLog(const std::string& path, const std::vector<Event>& events, bool write_index) {
+  ocm::LcmLogWriterOption option;
+  option.buffer_size = 1024;
+  option.buffer_count = 256;
+  option.preallocate_size = 4096;
+  option.write_index = write_index;
+  ocm::LcmLogWriter writer(path, option);
+  for (const auto& event : events) {
+    OCM_CHECK(writer.Append(event.channel, event.timestamp, reinterpret_cast<const uint8_t*>(event.payload.data()), event.payload.size()));
+  }
+  writer.Close();
+  OCM_CHECK(writer.GetError().empty());
+  OCM_CHECK(writer.GetEventCount() == events.size());
+  OCM_CHECK(writer.GetDroppedCount() == 0);
+}
+
+/**
+ * @brief 生成两个频道交替的事件。
+ */
+std::vector<Event> MakeEvents(size_t count) {
+  std::vector<Event> events;
+  for (size_t i = 0; i < count; ++i) {
+    const std::string channel = i % 3 == 0 ? "POSE" : "IMU";
+    events.push_back({channel, static_cast<int64_t>(1000 + i * 100), channel + "-" + std::to_string(i)});
+  }
+  return events;
+}
+
+/**
+ * @brief 检查读到的事件与录制的第 `i` 个事件一致。
+ */
+void CheckEvent(const ocm::LcmLogEvent& event, const std::vector<Event>& events, size_t i) {
+  OCM_CHECK(i < events.size());
+  OCM_CHECK(event.event_number == static_cast<int64_t>(i));
+  OCM_CHECK(event.timestamp == events[i].timestamp);
+  OCM_CHECK(event.channel == events[i].channel);
+  OCM_CHECK(std::string(reinterpret_cast<const char*>(event.data), event.size) == events[i].payload);
+}
+
+/**
+ * @brief 按文件顺序读取所有事件并与录制的事件比较，返回读到的事件数量。
+ */
+size_t CheckSequential(const ocm::LcmLogReader& reader, const std::vector<Event>& events) {
+  ocm::LcmLogEvent event;
+  uint64_t offset = 0;
+  size_t count = 0;
+  while (reader.ReadEvent(offset, &event, &offset)) {
+    CheckEvent(event, events, count++);
+  }
+  return count;
+}
+
+/**
+ * @brief 日志中一个事件的字节数。
+ */
+size_t EventSize(const Event& event) { return ocm::LCM_LOG_EVENT_HEADER_SIZE + event.channel.size() + event.payload.size(); }
+
+/**
+ * @brief 读取整个文件。
+ */
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  OCM_CHECK(file.good());
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief 以给定内容覆盖文件。
+ */
+void WriteFile(const std::string& path, const std::string& bytes) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  OCM_CHECK(file.good());
+}
+
+/**
+ * @brief 写入的日志可按文件顺序原样读回，预分配的空间在关闭时截掉；录制时写入的索引与扫描建立的索引一致。
+ */
+void TestRoundTrip() {
+  const std::string path = "/tmp/" + ocm::test::UniqueName("lcm_log_round_trip") + ".lcm";
+  const std::string index_path = ocm::GetLcmLogIndexPath(path);
+  const auto events = MakeEvents(300);
+  WriteLog(path, events, true);
+
+  size_t log_size = 0;
+  for (const auto& event : events) {
+    log_size += EventSize(event);
+  }
+  struct stat st;
+  OCM_CHECK(stat(path.c_str(), &st) == 0);
+  OCM_CHECK(static_cast<size_t>(st.st_size) == log_size);
+
+  ocm::LcmLogReader loaded(path);
+  OCM_CHECK(CheckSequential(loaded, events) == events.size());
+  OCM_CHECK(loaded.LoadIndex(index_path));
+  OCM_CHECK(loaded.GetChannels() == (std::vector<std::string>{"POSE", "IMU"}));
+  OCM_CHECK(loaded.GetIndex().size() == events.size());
+
+  ocm::LcmLogReader built(path);
+  built.BuildIndex();
+  OCM_CHECK(built.GetChannels() == loaded.GetChannels());
+  OCM_CHECK(built.GetIndex().size() == events.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& a = loaded.GetIndex()[i];
+    const auto& b = built.GetIndex()[i];
+    OCM_CHECK(a.offset == b.offset && a.timestamp == b.timestamp && a.channel == b.channel && a.size == b.size);
+    ocm::LcmLogEvent event;
+    OCM_CHECK(loaded.ReadEventAt(i, &event));
+    CheckEvent(event, events, i);
+  }
+  ocm::LcmLogEvent event;
+  OCM_CHECK(!loaded.ReadEventAt(events.size(), &event));
+
+  size_t visited = 0;
+  OCM_CHECK(loaded.ForEachEvent(0, [&](const ocm::LcmLogEvent& event) {
+    CheckEvent(event, events, visited++);
+    return true;
+  }) == events.size());
+  unlink(path.c_str());
+  unlink(index_path.c_str());
+}
+
+/**
+ * @brief 与 `lcm::LogFile` 一致，事件之间的垃圾数据被跳过，末尾不完整的事件被忽略，日志变化后旧索引不再加载。
+ */
+void TestDamaged() {
+  const std::string path = "/tmp/" + ocm::test::UniqueName("lcm_log_damaged") + ".lcm";
+  const std::string index_path = ocm::GetLcmLogIndexPath(path);
+  const auto events = MakeEvents(10);
+  WriteLog(path, events, true);
+
+  // 在第 5 个事件之前插入垃圾数据，末尾追加半个事件头部
+  std::string bytes = ReadFile(path);
+  size_t offset = 0;
+  for (size_t i = 0; i < 5; ++i) {
+    offset += EventSize(events[i]);
+  }
+  bytes.insert(offset, "garbage\xED\xA1");
+  bytes += bytes.substr(0, ocm::LCM_LOG_EVENT_HEADER_SIZE / 2);
+  WriteFile(path, bytes);
+
+  ocm::LcmLogReader reader(path);
+  OCM_CHECK(CheckSequential(reader, events) == events.size());
+  OCM_CHECK(!reader.LoadIndex(index_path));
+  reader.BuildIndex();
+  OCM_CHECK(reader.GetIndex().size() == events.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    ocm::LcmLogEvent event;
+    OCM_CHECK(reader.ReadEventAt(i, &event));
+    CheckEvent(event, events, i);
+  }
+  unlink(path.c_str());
+  unlink(index_path.c_str());
+}
+
+/**
+ * @brief 时间戳回退时按时间定位仍返回第一个不早于指定时刻的事件，按频道读取同样如此。
+ */
+void TestFindTimeNonMonotonic() {
+  const std::string path = "/tmp/" + ocm::test::UniqueName("lcm_log_find_time") + ".lcm";
+  const std::string index_path = ocm::GetLcmLogIndexPath(path);
+  const std::string saved_path = path + ".saved.idx";
+  // 时间戳整体递增，但相邻事件前后交错，模拟各话题的发布时刻交错和墙上时间被校准
+  auto events = MakeEvents(2000);
+  std::mt19937 rng(1);
+  for (auto& event : events) {
+    event.timestamp += static_cast<int64_t>(rng() % 5000) - 2500;
+  }
+  events[1000].timestamp -= 100000;
+  WriteLog(path, events, true);
+
+  ocm::LcmLogReader loaded(path);
+  OCM_CHECK(loaded.LoadIndex(index_path));
+  ocm::LcmLogReader built(path);
+  built.BuildIndex();
+  OCM_CHECK(built.SaveIndex(saved_path));
+  ocm::LcmLogReader saved(path);
+  OCM_CHECK(saved.LoadIndex(saved_path));
+
+  const int pose = loaded.FindChannel("POSE");
+  OCM_CHECK(pose >= 0);
+  OCM_CHECK(loaded.FindChannel("MISSING") == -1);
+  for (auto* reader : {&loaded, &built, &saved}) {
+    OCM_CHECK(reader->GetIndex().size() == events.size());
+    for (int64_t timestamp = -200000; timestamp < 300000; timestamp += 37) {
+      // 线性查找第一个不早于指定时刻的事件作为期望结果
+      size_t expected = 0;
+      while (expected < events.size() && events[expected].timestamp < timestamp) {
+        ++expected;
+      }
+      OCM_CHECK(reader->FindTime(timestamp) == expected);
+      int64_t first = -1;
+      reader->ForEachEvent(timestamp, [&](const ocm::LcmLogEvent& event) {
+        first = event.event_number;
+        return false;
+      });
+      OCM_CHECK(first == (expected < events.size() ? static_cast<int64_t>(expected) : -1));
+
+      int64_t expected_channel = -1;
+      for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].channel == "POSE" && events[i].timestamp >= timestamp) {
+          expected_channel = static_cast<int64_t>(i);
+          break;
+        }
+      }
+      int64_t first_channel = -1;
+      reader->ForEachChannelEvent(static_cast<uint32_t>(pose), timestamp, [&](const ocm::LcmLogEvent& event) {
+        OCM_CHECK(event.channel == "POSE");
+        first_channel = event.event_number;
+        return false;
+      });
+      OCM_CHECK(first_channel == expected_channel);
+    }
+  }
+  unlink(path.c_str());
+  unlink(index_path.c_str());
+  unlink(saved_path.c_str());
+}
+
+}  // namespace
+
+int main() {
+  TestRoundTrip();
+  TestDamaged();
+  TestFindTimeNonMonotonic();
+  printf("lcm_log_test passed\n");
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+/**
+ * @brief 订阅者等待消息的方式。
+ */
+enum class WaitKind { WAIT, TRY_WAIT, WAIT_TIMEOUT };
+
+/**
+ * @brief 按指定方式等待可读取的消息。
+ */
+bool WaitFor(ocm::SharedMemoryEndpoint& endpoint, ocm::SharedMemoryNotifier& notifier, WaitKind kind) {
+  switch (kind) {
+    case WaitKind::WAIT:
+      endpoint.Wait(notifier);
+      return true;
+    case WaitKind::TRY_WAIT:
+      return endpoint.TryWait(notifier);
+    case WaitKind::WAIT_TIMEOUT:
+      return endpoint.WaitTimeout(notifier, 100);
+  }
+  return false;
+}
+
+/**
+ * @brief 读取所有未读消息。
+ */
+std::vector<std::string> ReadAll(ocm::SharedMemoryEndpoint& endpoint) {
+  std::vector<std::string> messages;
+  endpoint.Snapshot([&](const uint8_t* data, size_t size) { messages.emplace_back(reinterpret_cast<const char*>(data), size); });
+  return messages;
+}
+
+/**
+ * @brief 环形布局下读取已到达的未读消息时同时取走通知。
+ *
+ * `ocm-replay --paced` 据此判断订阅者已处理上一条消息；通知不被取走时发布者一直等到超时，
+ * 订阅者之后的等待也会被这条旧通知唤醒而读不到消息。
+ */
+void TestUnreadTakesNotification(ocm::ShmNotifyMode notify_mode, WaitKind kind) {
+  const std::string topic = ocm::test::UniqueName("endpoint_unread");
+  {
+    ocm::SharedMemoryOption option;
+    option.layout = ocm::ShmLayout::RING;
+    option.slot_count = 8;
+    option.capacity = 64;
+    option.notify_mode = notify_mode;
+    ocm::SharedMemoryEndpoint publisher(topic, option);
+    ocm::SharedMemoryNotifier publisher_notifier(topic, notify_mode);
+    ocm::SharedMemoryEndpoint subscriber(topic, option);
+    ocm::SharedMemoryNotifier subscriber_notifier(topic, notify_mode);
+    auto publish = [&](const std::string& message) {
+      publisher.Write(message.size(), [&](uint8_t* dst) { memcpy(dst, message.data(), message.size()); });
+      publisher_notifier.Notify();
+    };
+
+    publish("first");
+    OCM_CHECK(WaitFor(subscriber, subscriber_notifier, kind));
+    OCM_CHECK(ReadAll(subscriber) == std::vector<std::string>{"first"});
+    OCM_CHECK(publisher_notifier.IsConsumed());
+
+    // 两条消息到达后只读取一次，之后仍有通知未取走时，有未读消息的等待应取走它
+    publish("second");
+    OCM_CHECK(WaitFor(subscriber, subscriber_notifier, kind));
+    publish("third");
+    OCM_CHECK(ReadAll(subscriber) == (std::vector<std::string>{"second", "third"}));
+    publish("fourth");
+    OCM_CHECK(WaitFor(subscriber, subscriber_notifier, kind));
+    OCM_CHECK(publisher_notifier.IsConsumed());
+    OCM_CHECK(ReadAll(subscriber) == std::vector<std::string>{"fourth"});
+    OCM_CHECK(!subscriber.TryWait(subscriber_notifier));
+    OCM_CHECK(!subscriber.WaitTimeout(subscriber_notifier, 0));
+  }
+  ocm::test::RemoveTopic(topic, topic);
+}
+
+}  // namespace
+
+int main() {
+  for (auto notify_mode : {ocm::ShmNotifyMode::SEMAPHORE, ocm::ShmNotifyMode::FUTEX}) {
+    for (auto kind : {WaitKind::WAIT, WaitKind::TRY_WAIT, WaitKind::WAIT_TIMEOUT}) {
+      TestUnreadTakesNotification(notify_mode, kind);
+    }
+  }
+  printf("shared_memory_endpoint_test passed\n");
+  return 0;
+}
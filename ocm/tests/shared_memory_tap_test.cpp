@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ocm/shared_memory_tap.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+/**
+ * @brief 写入一条字符串消息。
+ */
+void Write(ocm::SharedMemoryEndpoint& endpoint, const std::string& message) {
+  endpoint.Write(message.size(), [&](uint8_t* dst) { memcpy(dst, message.data(), message.size()); });
+}
+
+/**
+ * @brief 轮询或读取就绪话题，返回读到的消息。
+ */
+std::vector<std::string> Read(ocm::SharedMemoryTap& tap) {
+  std::vector<std::string> messages;
+  auto reader = [&](const uint8_t* data, size_t size) { messages.emplace_back(reinterpret_cast<const char*>(data), size); };
+  size_t count = tap.IsPolled() ? tap.Poll(reader) : tap.ReadReady(reader);
+  OCM_CHECK(count == messages.size());
+  return messages;
+}
+
+/**
+ * @brief 信号量通知的裸数据段按内容变化判断新消息，且不取走订阅者的通知。
+ */
+void TestPolledRaw() {
+  const std::string topic = ocm::test::UniqueName("tap_raw");
+  {
+    ocm::SharedMemoryTap tap(topic, topic, ocm::ShmNotifyMode::SEMAPHORE);
+    OCM_CHECK(tap.IsPolled());
+    // 发布者创建共享内存段之前不打开
+    OCM_CHECK(Read(tap).empty());
+    OCM_CHECK(!tap.GetEndpoint().IsOpen());
+
+    ocm::SharedMemoryEndpoint publisher(topic);
+    ocm::SharedMemoryNotifier notifier(topic, ocm::ShmNotifyMode::SEMAPHORE);
+    ocm::SharedMemoryNotifier subscriber(topic, ocm::ShmNotifyMode::SEMAPHORE);
+    Write(publisher, "aaaa");
+    notifier.Notify();
+    OCM_CHECK(Read(tap) == std::vector<std::string>{"aaaa"});
+    OCM_CHECK(Read(tap).empty());
+    OCM_CHECK(subscriber.IsPending());
+
+    // 相同内容只读到一次，内容变化后读到新消息
+    Write(publisher, "aaaa");
+    OCM_CHECK(Read(tap).empty());
+    Write(publisher, "bbbb");
+    OCM_CHECK(Read(tap) == std::vector<std::string>{"bbbb"});
+    OCM_CHECK(subscriber.TryWait());
+    OCM_CHECK(!tap.IsExcluded());
+  }
+  ocm::test::RemoveTopic(topic, topic);
+}
+
+/**
+ * @brief 信号量通知的环形布局按消息序号读取，相同内容的消息各读到一次，且不取走订阅者的通知。
+ */
+void TestPolledRing() {
+  const std::string topic = ocm::test::UniqueName("tap_ring");
+  {
+    ocm::SharedMemoryOption option;
+    option.layout = ocm::ShmLayout::RING;
+    option.slot_count = 8;
+    option.capacity = 64;
+    ocm::SharedMemoryEndpoint publisher(topic, option);
+    ocm::SharedMemoryNotifier notifier(topic, ocm::ShmNotifyMode::SEMAPHORE);
+    ocm::SharedMemoryNotifier subscriber(topic, ocm::ShmNotifyMode::SEMAPHORE);
+    ocm::SharedMemoryTap tap(topic, topic, ocm::ShmNotifyMode::SEMAPHORE);
+    // 打开共享内存段时从最新一条消息开始读取
+    Write(publisher, "zero");
+    Write(publisher, "latest");
+    OCM_CHECK(Read(tap) == std::vector<std::string>{"latest"});
+    for (const char* message : {"one", "two", "two"}) {
+      Write(publisher, message);
+      notifier.Notify();
+    }
+    OCM_CHECK(Read(tap) == (std::vector<std::string>{"one", "two", "two"}));
+    OCM_CHECK(Read(tap).empty());
+    Write(publisher, "three");
+    OCM_CHECK(Read(tap) == std::vector<std::string>{"three"});
+    OCM_CHECK(subscriber.IsPending());
+  }
+  ocm::test::RemoveTopic(topic, topic);
+}
+
+/**
+ * @brief futex 通知的话题在通知就绪后读取新消息。
+ */
+void TestReady() {
+  const std::string topic = ocm::test::UniqueName("tap_futex");
+  {
+    ocm::SharedMemoryOption option;
+    option.notify_mode = ocm::ShmNotifyMode::FUTEX;
+    option.capacity = 64;
+    ocm::SharedMemoryTap tap(topic, topic, ocm::ShmNotifyMode::FUTEX);
+    OCM_CHECK(!tap.IsPolled());
+    OCM_CHECK(Read(tap).empty());
+
+    ocm::SharedMemoryEndpoint publisher(topic, option);
+    ocm::SharedMemoryNotifier notifier(topic, ocm::ShmNotifyMode::FUTEX);
+    Write(publisher, "ready");
+    notifier.Notify();
+    OCM_CHECK(tap.GetNotifier().IsPending());
+    OCM_CHECK(Read(tap) == std::vector<std::string>{"ready"});
+    OCM_CHECK(!tap.GetNotifier().IsPending());
+    OCM_CHECK(Read(tap).empty());
+  }
+  ocm::test::RemoveTopic(topic, topic);
+}
+
+/**
+ * @brief 三缓冲布局只允许一个读者，旁路读者不读取也不占用读者位置。
+ */
+void TestTriple() {
+  const std::string topic = ocm::test::UniqueName("tap_triple");
+  {
+    ocm::SharedMemoryOption option;
+    option.layout = ocm::ShmLayout::TRIPLE;
+    option.capacity = 64;
+    ocm::SharedMemoryEndpoint publisher(topic, option);
+    ocm::SharedMemoryTap tap(topic, topic, ocm::ShmNotifyMode::SEMAPHORE);
+    Write(publisher, "latest");
+    OCM_CHECK(Read(tap).empty());
+    OCM_CHECK(tap.IsExcluded());
+
+    ocm::SharedMemoryEndpoint reader(topic, option);
+    reader.Open(false);
+    std::vector<std::string> messages;
+    reader.Snapshot([&](const uint8_t* data, size_t size) { messages.emplace_back(reinterpret_cast<const char*>(data), size); });
+    OCM_CHECK(messages == std::vector<std::string>{"latest"});
+  }
+  ocm::test::RemoveTopic(topic, topic);
+}
+
+}  // namespace
+
+int main() {
+  TestPolledRaw();
+  TestPolledRing();
+  TestReady();
+  TestTriple();
+  printf("shared_memory_tap_test passed\n");
+  return 0;
+}
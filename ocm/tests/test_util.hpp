@@ -0,0 +1,47 @@
+#pragma once
+
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "common/prefix_string.hpp"
+
+/**
+ * @brief 检查条件，不成立时打印位置并以失败状态退出。
+ *
+ * 不依赖 `assert`，Release 构建中同样生效。
+ */
+#define OCM_CHECK(condition)                                                          \
+  do {                                                                                \
+    if (!(condition)) {                                                               \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      exit(1);                                                                        \
+    }                                                                                 \
+  } while (0)
+
+namespace ocm::test {
+/**
+ * @brief 生成本次运行唯一的名称，避免与其他进程或上次运行残留的共享内存段冲突。
+ *
+ * @param base 名称前缀。
+ * @return 带进程号后缀的名称。
+ */
+inline std::string UniqueName(const std::string& base) { return base + "_" + std::to_string(getpid()); }
+
+/**
+ * @brief 删除测试创建的共享内存段、通知段和信号量。
+ *
+ * 注册表条目不删除，由 `ocm-topic reclaim` 回收。
+ *
+ * @param topic_name 主题名。
+ * @param shm_name 共享内存段的名称。
+ */
+inline void RemoveTopic(const std::string& topic_name, const std::string& shm_name) {
+  shm_unlink(GetNamePrefix(shm_name).c_str());
+  sem_unlink(GetNamePrefix(shm_name + "_shm").c_str());
+  sem_unlink(GetNamePrefix(topic_name).c_str());
+  shm_unlink(GetNamePrefix(topic_name + "_notify").c_str());
+}
+}  // namespace ocm::test
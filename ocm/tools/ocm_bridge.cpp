@@ -0,0 +1,544 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ocm/bridge_protocol.hpp"
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_notifier.hpp"
+#include "ocm/shared_memory_registry.hpp"
+#include "ocm/shared_memory_tap.hpp"
+#include "ocm/shared_memory_wait_set.hpp"
+
+namespace {
+
+/**
+ * @brief 默认的数据报最大字节数，不超过以太网 MTU，避免 IP 分片。
+ */
+constexpr size_t kDefaultDatagramSize = 1472;
+
+/**
+ * @brief 一次 `sendmmsg` 或 `recvmmsg` 处理的最大数据报数量。
+ */
+constexpr size_t kMaxBatch = 64;
+
+/**
+ * @brief 限速和延迟合并使用的定时器周期（纳秒）。
+ */
+constexpr uint64_t kTickPeriod = 1000000;
+
+/**
+ * @brief 检查退出信号的间隔（毫秒）。
+ */
+constexpr int kStopCheckInterval = 100;
+
+/**
+ * @brief 退出标志，由 SIGINT 和 SIGTERM 设置。
+ */
+volatile std::sig_atomic_t stop_requested = 0;
+
+/**
+ * @brief 转发的话题。
+ */
+struct ForwardTopic {
+  std::string topic_name;                    /**< 主题名。 */
+  std::string shm_name;                      /**< 共享内存段的名称。 */
+  uint64_t min_interval = 0;                 /**< 转发的最小间隔（纳秒），为 0 时不限速。 */
+  uint64_t next_time = 0;                    /**< 限速时下一次允许转发的时刻。 */
+  bool pending = false;                      /**< 限速时是否有尚未转发的最新消息。 */
+  bool warned = false;                       /**< 是否已提示三缓冲布局的话题不转发。 */
+  int64_t type_hash = 0;                     /**< 最新消息的类型哈希。 */
+  std::vector<uint8_t> latest;               /**< 限速时暂存的最新消息。 */
+  std::unique_ptr<ocm::SharedMemoryTap> tap; /**< 话题的旁路读者。 */
+  uint64_t forwarded = 0;                    /**< 已转发的消息数量。 */
+  uint64_t skipped = 0;                      /**< 因限速未转发的消息数量。 */
+};
+
+/**
+ * @brief 桥接配置。
+ */
+struct BridgeConfig {
+  std::string command;                                            /**< `send` 或 `recv`。 */
+  std::vector<std::string> topics;                                /**< 话题描述，格式为 `topic[:shm][@hz]`。 */
+  std::string dest;                                               /**< 发送端的目的地址 `addr:port`。 */
+  std::string group;                                              /**< 接收端加入的组播地址。 */
+  int port = 0;                                                   /**< 接收端监听的端口。 */
+  size_t datagram_size = kDefaultDatagramSize;                    /**< 合并消息时数据报的最大字节数。 */
+  uint64_t linger = 0;                                            /**< 未满的数据报最多等待的时间（纳秒）。 */
+  int ttl = 1;                                                    /**< 组播 TTL。 */
+  std::string prefix;                                             /**< 接收端重新发布时主题名和共享内存段名称的前缀。 */
+  size_t capacity = ocm::BRIDGE_MAX_DATAGRAM_SIZE;                /**< 接收端创建共享内存段的容量，默认可容纳数据报能携带的最大消息。 */
+  ocm::ShmNotifyMode notify_mode = ocm::ShmNotifyMode::SEMAPHORE; /**< 注册表中找不到话题时使用的通知方式。 */
+};
+
+/**
+ * @brief 打印用法。
+ */
+void PrintUsage() {
+  printf(
+      "Usage: ocm-bridge send --dest <addr:port> --topic <spec> [--topic <spec> ...] [options]\n"
+      "       ocm-bridge recv --port <port> [options]\n"
+      "  --topic <topic[:shm][@hz]>  send: topic to forward, optionally rate limited; recv: only republish these topics\n"
+      "  --dest <addr:port>          send: destination address, unicast or multicast\n"
+      "  --datagram <bytes>          send: coalesce messages into datagrams up to this size (default 1472)\n"
+      "  --linger <us>               send: hold a partial datagram up to this long to coalesce more (default 0)\n"
+      "  --ttl <n>                   send: multicast TTL (default 1)\n"
+      "  --port <port>               recv: UDP port to listen on\n"
+      "  --group <addr>              recv: multicast group to join\n"
+      "  --prefix <text>             recv: prepend to republished topic and shm names\n"
+      "  --capacity <bytes>          recv: capacity of created shm segments (default 65507, the largest message a datagram carries)\n"
+      "  --notify <mode>             semaphore or futex, used for topics not found in the registry (default semaphore)\n");
+}
+
+/**
+ * @brief 解析命令行参数。
+ *
+ * @return 参数有效时返回 `true`。
+ */
+bool ParseArguments(int argc, char** argv, BridgeConfig* config) {
+  if (argc < 2) {
+    return false;
+  }
+  config->command = argv[1];
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[++i];
+    if (arg == "--topic") {
+      config->topics.push_back(value);
+    } else if (arg == "--dest") {
+      config->dest = value;
+    } else if (arg == "--datagram") {
+      config->datagram_size = std::min<size_t>(strtoull(value.c_str(), nullptr, 10), ocm::BRIDGE_MAX_DATAGRAM_SIZE);
+    } else if (arg == "--linger") {
+      config->linger = strtoull(value.c_str(), nullptr, 10) * 1000;
+    } else if (arg == "--ttl") {
+      config->ttl = atoi(value.c_str());
+    } else if (arg == "--port") {
+      config->port = atoi(value.c_str());
+    } else if (arg == "--group") {
+      config->group = value;
+    } else if (arg == "--prefix") {
+      config->prefix = value;
+    } else if (arg == "--capacity") {
+      config->capacity = strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--notify") {
+      config->notify_mode = value == "futex" ? ocm::ShmNotifyMode::FUTEX : ocm::ShmNotifyMode::SEMAPHORE;
+    } else {
+      return false;
+    }
+  }
+  if (config->command == "send") {
+    return !config->dest.empty() && !config->topics.empty() &&
+           config->datagram_size > sizeof(ocm::BridgeDatagramHeader) + sizeof(ocm::BridgeRecordHeader);
+  }
+  return config->command == "recv" && config->port > 0;
+}
+
+/**
+ * @brief 解析话题描述 `topic[:shm][@hz]`，共享内存段名称缺省时与主题名相同。
+ */
+void ParseTopic(const std::string& spec, std::string* topic_name, std::string* shm_name, double* rate) {
+  std::string name = spec;
+  *rate = 0.0;
+  size_t at = name.find('@');
+  if (at != std::string::npos) {
+    *rate = atof(name.c_str() + at + 1);
+    name.resize(at);
+  }
+  size_t colon = name.find(':');
+  *topic_name = name.substr(0, colon);
+  *shm_name = colon == std::string::npos ? *topic_name : name.substr(colon + 1);
+}
+
+/**
+ * @brief 获取话题的通知方式：优先使用注册表中记录的设置。
+ */
+ocm::ShmNotifyMode GetNotifyMode(const std::string& topic_name, ocm::ShmNotifyMode fallback) {
+  auto& registry = ocm::SharedMemoryRegistry::getInstance();
+  ocm::SharedMemoryTopicInfo info;
+  return registry.IsAvailable() && registry.Find(topic_name, &info) ? info.option.notify_mode : fallback;
+}
+
+/**
+ * @brief 解析 `addr:port` 形式的地址。
+ *
+ * @return 解析成功时返回 `true`。
+ */
+bool ParseAddress(const std::string& text, sockaddr_in* address) {
+  size_t colon = text.rfind(':');
+  if (colon == std::string::npos) {
+    return false;
+  }
+  memset(address, 0, sizeof(*address));
+  address->sin_family = AF_INET;
+  address->sin_port = htons(static_cast<uint16_t>(atoi(text.c_str() + colon + 1)));
+  return inet_pton(AF_INET, text.substr(0, colon).c_str(), &address->sin_addr) == 1;
+}
+
+/**
+ * @class DatagramBatcher
+ * @brief 将消息记录合并到数据报中，并以 `sendmmsg` 一次发送多个数据报。
+ */
+class DatagramBatcher {
+ public:
+  /**
+   * @brief 构造数据报合并器。
+   *
+   * @param socket 已创建的 UDP 套接字。
+   * @param dest 目的地址。
+   * @param datagram_size 合并时数据报的最大字节数。
+   */
+  DatagramBatcher(int socket, const sockaddr_in& dest, size_t datagram_size)
+      : socket_(socket), dest_(dest), builder_(datagram_size, static_cast<uint32_t>(getpid())) {}
+
+  /**
+   * @brief 追加一条消息记录。
+   *
+   * @return 记录超过 UDP 数据报上限而被丢弃时返回 `false`。
+   */
+  bool Add(const std::string& topic_name, const std::string& shm_name, int64_t type_hash, const uint8_t* data, size_t size) {
+    if (builder_.Empty()) {
+      first_time_ = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    }
+    return builder_.Add(topic_name, shm_name, type_hash, data, size);
+  }
+
+  /**
+   * @brief 判断是否有尚未发送的数据报。
+   */
+  bool Empty() const { return builder_.Empty(); }
+
+  /**
+   * @brief 获取最早一条未发送记录的加入时刻。
+   */
+  uint64_t GetFirstTime() const { return first_time_; }
+
+  /**
+   * @brief 发送所有未发送的数据报。
+   *
+   * @return 发送失败的数据报数量。
+   */
+  size_t Flush() {
+    const auto& datagrams = builder_.GetDatagrams();
+    size_t failed = 0;
+    for (size_t begin = 0; begin < datagrams.size(); begin += kMaxBatch) {
+      size_t count = std::min(kMaxBatch, datagrams.size() - begin);
+      for (size_t i = 0; i < count; ++i) {
+        iovecs_[i] = {const_cast<uint8_t*>(datagrams[begin + i].data()), datagrams[begin + i].size()};
+        messages_[i] = {};
+        messages_[i].msg_hdr.msg_name = &dest_;
+        messages_[i].msg_hdr.msg_namelen = sizeof(dest_);
+        messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+        messages_[i].msg_hdr.msg_iovlen = 1;
+      }
+      size_t sent = 0;
+      while (sent < count) {
+        int result = sendmmsg(socket_, messages_ + sent, static_cast<unsigned int>(count - sent), 0);
+        if (result < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          // 跳过发送失败的数据报，继续发送其余数据报
+          ++failed;
+          ++sent;
+          continue;
+        }
+        sent += static_cast<size_t>(result);
+      }
+    }
+    sent_ += datagrams.size() - failed;
+    builder_.Clear();
+    return failed;
+  }
+
+  /**
+   * @brief 获取已发送的数据报数量。
+   */
+  uint64_t GetSentCount() const { return sent_; }
+
+ private:
+  int socket_;                         /**< UDP 套接字。 */
+  sockaddr_in dest_;                   /**< 目的地址。 */
+  ocm::BridgeDatagramBuilder builder_; /**< 数据报合并器。 */
+  iovec iovecs_[kMaxBatch];            /**< 一次 `sendmmsg` 的数据报缓冲区描述。 */
+  mmsghdr messages_[kMaxBatch];        /**< 一次 `sendmmsg` 的消息头。 */
+  uint64_t first_time_ = 0;            /**< 最早一条未发送记录的加入时刻。 */
+  uint64_t sent_ = 0;                  /**< 已发送的数据报数量。 */
+};
+
+/**
+ * @brief 发送端：订阅共享内存话题并转发到 UDP。
+ *
+ * 命名信号量由所有订阅者共享，取走通知会使本地订阅者错过消息，因此信号量通知的话题不加入等待集，
+ * 而是每个定时器周期按消息序号轮询，不消耗通知；裸数据段没有序号，按内容变化判断新消息。
+ */
+int RunSend(const BridgeConfig& config) {
+  sockaddr_in dest;
+  if (!ParseAddress(config.dest, &dest)) {
+    fprintf(stderr, "ocm-bridge: invalid destination \"%s\"\n", config.dest.c_str());
+    return 1;
+  }
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    fprintf(stderr, "ocm-bridge: socket failed: %s\n", strerror(errno));
+    return 1;
+  }
+  unsigned char ttl = static_cast<unsigned char>(config.ttl);
+  setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+  std::vector<ForwardTopic> topics(config.topics.size());
+  std::vector<ForwardTopic*> waited;
+  ocm::SharedMemoryWaitSet wait_set;
+  bool need_tick = config.linger > 0;
+  for (size_t i = 0; i < topics.size(); ++i) {
+    auto& topic = topics[i];
+    double rate = 0.0;
+    ParseTopic(config.topics[i], &topic.topic_name, &topic.shm_name, &rate);
+    topic.min_interval = rate > 0 ? static_cast<uint64_t>(1e9 / rate) : 0;
+    need_tick = need_tick || topic.min_interval > 0;
+    const auto mode = GetNotifyMode(topic.topic_name, config.notify_mode);
+    topic.tap = std::make_unique<ocm::SharedMemoryTap>(topic.topic_name, topic.shm_name, mode);
+    need_tick = need_tick || topic.tap->IsPolled();
+    if (!topic.tap->IsPolled()) {
+      wait_set.Attach(topic.tap->GetNotifier());
+      waited.push_back(&topic);
+    }
+  }
+  if (need_tick) {
+    wait_set.AttachTimer(kTickPeriod);
+  }
+
+  DatagramBatcher batcher(sock, dest, config.datagram_size);
+  uint64_t oversize = 0;
+  uint64_t failed = 0;
+  auto forward = [&](ForwardTopic& topic, bool polled) {
+    auto reader = [&](const uint8_t* data, size_t size) {
+      int64_t type_hash = topic.tap->GetEndpoint().GetMessageHeader().type_hash;
+      if (topic.min_interval == 0) {
+        if (batcher.Add(topic.topic_name, topic.shm_name, type_hash, data, size)) {
+          ++topic.forwarded;
+        } else {
+          ++oversize;
+        }
+        return;
+      }
+      // 限速话题只暂存最新消息，到期后转发
+      topic.skipped += topic.pending ? 1 : 0;
+      topic.latest.assign(data, data + size);
+      topic.type_hash = type_hash;
+      topic.pending = true;
+    };
+    if (polled) {
+      topic.tap->Poll(reader);
+    } else {
+      topic.tap->ReadReady(reader);
+    }
+    if (topic.tap->IsExcluded() && !topic.warned) {
+      topic.warned = true;
+      fprintf(stderr, "ocm-bridge: %s uses the triple layout, which allows a single reader; not forwarding it\n", topic.topic_name.c_str());
+    }
+  };
+  while (!stop_requested) {
+    for (size_t index : wait_set.WaitTimeout(kStopCheckInterval)) {
+      // 定时器条目排在话题之后
+      if (index >= waited.size()) {
+        continue;
+      }
+      forward(*waited[index], false);
+    }
+    for (auto& topic : topics) {
+      if (topic.tap->IsPolled()) {
+        forward(topic, true);
+      }
+    }
+    const uint64_t now = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    for (auto& topic : topics) {
+      if (topic.pending && now >= topic.next_time) {
+        if (batcher.Add(topic.topic_name, topic.shm_name, topic.type_hash, topic.latest.data(), topic.latest.size())) {
+          ++topic.forwarded;
+        } else {
+          ++oversize;
+        }
+        topic.pending = false;
+        topic.next_time = now + topic.min_interval;
+      }
+    }
+    if (!batcher.Empty() && (config.linger == 0 || now - batcher.GetFirstTime() >= config.linger)) {
+      failed += batcher.Flush();
+    }
+  }
+  failed += batcher.Flush();
+  close(sock);
+
+  for (const auto& topic : topics) {
+    if (topic.tap->IsExcluded()) {
+      fprintf(stderr, "ocm-bridge: %s skipped, triple layout\n", topic.topic_name.c_str());
+      continue;
+    }
+    fprintf(stderr, "ocm-bridge: %s forwarded %llu, rate limited %llu\n", topic.topic_name.c_str(), static_cast<unsigned long long>(topic.forwarded),
+            static_cast<unsigned long long>(topic.skipped));
+  }
+  fprintf(stderr, "ocm-bridge: %llu datagrams sent, %llu failed, %llu oversize messages dropped\n",
+          static_cast<unsigned long long>(batcher.GetSentCount()), static_cast<unsigned long long>(failed),
+          static_cast<unsigned long long>(oversize));
+  return 0;
+}
+
+/**
+ * @brief 接收端重新发布的话题。
+ */
+struct RepublishTopic {
+  std::unique_ptr<ocm::SharedMemoryNotifier> notifier; /**< 话题的通知器。 */
+  std::unique_ptr<ocm::SharedMemoryEndpoint> endpoint; /**< 共享内存段的端点。 */
+  uint64_t published = 0;                              /**< 已重新发布的消息数量。 */
+  uint64_t errors = 0;                                 /**< 重新发布失败的消息数量。 */
+};
+
+/**
+ * @brief 接收端：从 UDP 接收消息并重新发布到共享内存话题。
+ */
+int RunRecv(const BridgeConfig& config) {
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    fprintf(stderr, "ocm-bridge: socket failed: %s\n", strerror(errno));
+    return 1;
+  }
+  int reuse = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  timeval timeout{0, kStopCheckInterval * 1000};
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<uint16_t>(config.port));
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    fprintf(stderr, "ocm-bridge: bind to port %d failed: %s\n", config.port, strerror(errno));
+    close(sock);
+    return 1;
+  }
+  if (!config.group.empty()) {
+    ip_mreq request{};
+    if (inet_pton(AF_INET, config.group.c_str(), &request.imr_multiaddr) != 1 ||
+        setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof(request)) != 0) {
+      fprintf(stderr, "ocm-bridge: failed to join group \"%s\": %s\n", config.group.c_str(), strerror(errno));
+      close(sock);
+      return 1;
+    }
+  }
+
+  std::vector<std::string> filter;
+  for (const auto& spec : config.topics) {
+    std::string topic_name, shm_name;
+    double rate = 0.0;
+    ParseTopic(spec, &topic_name, &shm_name, &rate);
+    filter.push_back(topic_name);
+  }
+  ocm::SharedMemoryOption option;
+  option.capacity = config.capacity;
+  std::unordered_map<std::string, RepublishTopic> republished;
+  ocm::BridgeSequenceTracker sequences;
+  std::vector<std::vector<uint8_t>> buffers(kMaxBatch, std::vector<uint8_t>(ocm::BRIDGE_MAX_DATAGRAM_SIZE));
+  std::vector<iovec> iovecs(kMaxBatch);
+  std::vector<mmsghdr> messages(kMaxBatch);
+  uint64_t datagrams = 0;
+  uint64_t malformed = 0;
+  uint64_t errors = 0;
+
+  while (!stop_requested) {
+    for (size_t i = 0; i < kMaxBatch; ++i) {
+      iovecs[i] = {buffers[i].data(), buffers[i].size()};
+      messages[i] = {};
+      messages[i].msg_hdr.msg_iov = &iovecs[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    int count = recvmmsg(sock, messages.data(), kMaxBatch, MSG_WAITFORONE, nullptr);
+    if (count <= 0) {
+      continue;
+    }
+    for (int i = 0; i < count; ++i) {
+      const uint8_t* data = buffers[i].data();
+      size_t size = messages[i].msg_len;
+      ocm::BridgeDatagramHeader header;
+      if (!ocm::ParseBridgeDatagramHeader(data, size, &header)) {
+        ++malformed;
+        continue;
+      }
+      ++datagrams;
+      sequences.Track(header.sender, header.sequence);
+      bool complete = ocm::ForEachBridgeRecord(data, size, [&](const ocm::BridgeRecord& record) {
+        if (!filter.empty() && std::find(filter.begin(), filter.end(), record.topic_name) == filter.end()) {
+          return;
+        }
+        std::string topic_name = config.prefix + std::string(record.topic_name);
+        std::string shm_name = config.prefix + std::string(record.shm_name);
+        auto& topic = republished[shm_name];
+        try {
+          if (!topic.endpoint) {
+            topic.notifier = std::make_unique<ocm::SharedMemoryNotifier>(topic_name, GetNotifyMode(topic_name, config.notify_mode));
+            topic.endpoint = std::make_unique<ocm::SharedMemoryEndpoint>(shm_name, option, record.type_hash);
+            topic.endpoint->Advertise(topic_name, "", ocm::ShmRole::PUBLISHER);
+          }
+          topic.endpoint->Write(record.size, [&](uint8_t* dst) { memcpy(dst, record.data, record.size); });
+          topic.notifier->Notify();
+          ++topic.published;
+        } catch (const std::exception& e) {
+          ++errors;
+          if (topic.errors++ == 0) {
+            fprintf(stderr, "ocm-bridge: failed to republish \"%s\": %s\n", topic_name.c_str(), e.what());
+          }
+        }
+      });
+      malformed += complete ? 0 : 1;
+    }
+  }
+  close(sock);
+
+  for (const auto& [shm_name, topic] : republished) {
+    fprintf(stderr, "ocm-bridge: %s republished %llu, failed %llu\n", shm_name.c_str(), static_cast<unsigned long long>(topic.published),
+            static_cast<unsigned long long>(topic.errors));
+  }
+  fprintf(stderr, "ocm-bridge: %llu datagrams received, %llu lost, %llu reordered, %llu malformed, %llu republish errors\n",
+          static_cast<unsigned long long>(datagrams), static_cast<unsigned long long>(sequences.GetLostCount()),
+          static_cast<unsigned long long>(sequences.GetReorderedCount()), static_cast<unsigned long long>(malformed),
+          static_cast<unsigned long long>(errors));
+  return 0;
+}
+
+/**
+ * @brief 退出信号处理函数。
+ */
+void HandleSignal(int) { stop_requested = 1; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BridgeConfig config;
+  if (!ParseArguments(argc, argv, &config)) {
+    PrintUsage();
+    return 1;
+  }
+  struct sigaction action {};
+  action.sa_handler = HandleSignal;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+  try {
+    return config.command == "send" ? RunSend(config) : RunRecv(config);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "ocm-bridge: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,714 @@
+#include <lcm/lcm_coretypes.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "common/prefix_string.hpp"
+#include "ocm/shared_memory_topic_lcm.hpp"
+
+namespace {
+
+/**
+ * @brief 单次运行最多传输的字节数，大消息按此减少消息数量。
+ */
+constexpr uint64_t kMaxBytesPerRun = 1ULL << 30;
+
+/**
+ * @brief 单次运行最少发送的消息数量。
+ */
+constexpr uint64_t kMinMessages = 20;
+
+/**
+ * @brief 订阅者在发布者退出后仍未结束时的等待上限（毫秒），也是发布者等待订阅者的上限。
+ */
+constexpr int kDrainTimeout = 5000;
+
+/**
+ * @brief 预热消息的序号。发布者重复发送预热消息，直到订阅者已打开共享内存段并收到它。
+ */
+constexpr int64_t kWarmupSeq = -2;
+
+/**
+ * @brief 发布者重发预热消息的间隔（纳秒）。
+ */
+constexpr uint64_t kWarmupInterval = 1000000;
+
+/**
+ * @brief 本进程的堆分配次数，由下方替换的全局 `operator new` 统计，用于检查稳态接收路径不分配内存。
+ */
+std::atomic<uint64_t> allocation_count{0};
+
+/**
+ * @class BenchMessage
+ * @brief 基准测试消息，按 LCM 编码规则携带序号、发送时刻和指定大小的负载。
+ */
+class BenchMessage {
+ public:
+  int64_t seq = 0;           /**< 消息序号，负数表示结束。 */
+  int64_t send_time = 0;     /**< 发送时刻，`CLOCK_MONOTONIC` 下的纳秒数。 */
+  std::vector<uint8_t> data; /**< 负载。 */
+
+  /**
+   * @brief 将消息编码为 LCM 二进制格式。
+   */
+  int encode(void* buf, int offset, int maxlen) const {
+    int pos = 0, tlen;
+    int64_t hash = getHash();
+    int32_t size = static_cast<int32_t>(data.size());
+    if ((tlen = __int64_t_encode_array(buf, offset + pos, maxlen - pos, &hash, 1)) < 0) return tlen;
+    pos += tlen;
+    if ((tlen = __int64_t_encode_array(buf, offset + pos, maxlen - pos, &seq, 1)) < 0) return tlen;
+    pos += tlen;
+    if ((tlen = __int64_t_encode_array(buf, offset + pos, maxlen - pos, &send_time, 1)) < 0) return tlen;
+    pos += tlen;
+    if ((tlen = __int32_t_encode_array(buf, offset + pos, maxlen - pos, &size, 1)) < 0) return tlen;
+    pos += tlen;
+    if ((tlen = __byte_encode_array(buf, offset + pos, maxlen - pos, data.data(), size)) < 0) return tlen;
+    return pos + tlen;
+  }
+
+  /**
+   * @brief 获取编码此消息所需的总字节数。
+   */
+  int getEncodedSize() const { return 8 + 8 + 8 + 4 + static_cast<int>(data.size()); }
+
+  /**
+   * @brief 从 LCM 二进制格式解码消息，复用负载的容量。
+   */
+  int decode(const void* buf, int offset, int maxlen) {
+    int pos = 0, tlen;
+    int64_t hash = 0;
+    int32_t size = 0;
+    if ((tlen = __int64_t_decode_array(buf, offset + pos, maxlen - pos, &hash, 1)) < 0) return tlen;
+    pos += tlen;
+    if (hash != getHash()) return -1;
+    if ((tlen = __int64_t_decode_array(buf, offset + pos, maxlen - pos, &seq, 1)) < 0) return tlen;
+    pos += tlen;
+    if ((tlen = __int64_t_decode_array(buf, offset + pos, maxlen - pos, &send_time, 1)) < 0) return tlen;
+    pos += tlen;
+    if ((tlen = __int32_t_decode_array(buf, offset + pos, maxlen - pos, &size, 1)) < 0) return tlen;
+    pos += tlen;
+    if (size < 0 || size > maxlen - pos) return -1;
+    data.resize(size);
+    if ((tlen = __byte_decode_array(buf, offset + pos, maxlen - pos, data.data(), size)) < 0) return tlen;
+    return pos + tlen;
+  }
+
+  /**
+   * @brief 获取消息类型哈希。
+   */
+  static int64_t getHash() { return 0x6f636d62656e6368LL; }
+
+  /**
+   * @brief 获取消息类型名称。
+   */
+  static const char* getTypeName() { return "BenchMessage"; }
+};
+
+/**
+ * @brief 被测的共享内存段模式。
+ */
+struct BenchMode {
+  const char* name;               /**< 模式名称。 */
+  ocm::SharedMemoryOption option; /**< 共享内存段的选项。 */
+};
+
+/**
+ * @brief 基准测试配置。
+ */
+struct BenchConfig {
+  std::vector<size_t> sizes;                                      /**< 负载大小（字节）。 */
+  std::vector<std::string> modes;                                 /**< 被测的模式名称。 */
+  std::vector<std::string> apis;                                  /**< 被测的订阅接口：`subscribe`、`nowait` 或 `owned`。 */
+  uint64_t count = 2000;                                          /**< 每次运行发送的消息数量上限。 */
+  double rate = 1000.0;                                           /**< 延迟测试的发送频率（Hz）。 */
+  int publisher_cpu = -1;                                         /**< 发布者绑定的 CPU，-1 表示不绑定。 */
+  int subscriber_cpu = -1;                                        /**< 订阅者绑定的 CPU，-1 表示不绑定。 */
+  ocm::ShmNotifyMode notify_mode = ocm::ShmNotifyMode::SEMAPHORE; /**< 通知方式。 */
+  std::string output;                                             /**< JSON 输出文件，为空时输出到标准输出。 */
+};
+
+/**
+ * @brief 订阅者进程的测量结果，经管道传回父进程。
+ */
+struct SubscriberReport {
+  uint64_t received = 0;                 /**< 收到的消息数量。 */
+  uint64_t latency_min = 0;              /**< 最小单向延迟（纳秒）。 */
+  uint64_t latency_mean = 0;             /**< 平均单向延迟（纳秒）。 */
+  uint64_t latency_p50 = 0;              /**< 单向延迟的 50 分位（纳秒）。 */
+  uint64_t latency_p99 = 0;              /**< 单向延迟的 99 分位（纳秒）。 */
+  uint64_t latency_p999 = 0;             /**< 单向延迟的 99.9 分位（纳秒）。 */
+  uint64_t latency_max = 0;              /**< 最大单向延迟（纳秒）。 */
+  uint64_t first_time = 0;               /**< 收到第一条消息的时刻。 */
+  uint64_t last_time = 0;                /**< 收到最后一条消息的时刻。 */
+  uint64_t allocations = 0;              /**< 收到第一条消息之后、结束消息之前的堆分配次数。 */
+  ocm::SharedMemoryLockStats lock_stats; /**< 读取时的持锁时间统计。 */
+  int error = 0;                         /**< 非 0 表示订阅者出错。 */
+};
+
+/**
+ * @brief 发布者进程的测量结果，经管道传回父进程。
+ */
+struct PublisherReport {
+  uint64_t sent = 0;                     /**< 发送的消息数量。 */
+  uint64_t start_time = 0;               /**< 开始发送的时刻。 */
+  uint64_t end_time = 0;                 /**< 发送完最后一条消息的时刻。 */
+  ocm::SharedMemoryLockStats lock_stats; /**< 写入时的持锁时间统计。 */
+  int error = 0;                         /**< 非 0 表示发布者出错。 */
+};
+
+/**
+ * @brief 父进程在派生前创建的共享控制块，发布者和订阅者进程共享。
+ */
+struct BenchControl {
+  std::atomic<uint32_t> ready;    /**< 订阅者收到预热消息后置 1，此时共享内存段已打开、环形游标已同步。 */
+  std::atomic<uint64_t> received; /**< 订阅者已处理的消息数量，吞吐测试的发布者据此施加背压。 */
+};
+
+/**
+ * @brief 一次运行的参数。
+ */
+struct BenchRun {
+  const BenchMode* mode = nullptr; /**< 被测的模式。 */
+  std::string api;                 /**< 被测的订阅接口。 */
+  size_t size = 0;                 /**< 负载大小（字节）。 */
+  uint64_t count = 0;              /**< 发送的消息数量。 */
+  double rate = 0.0;               /**< 发送频率（Hz），为 0 时不限速。 */
+};
+
+/**
+ * @brief 获取所有可测的模式。
+ */
+const std::vector<BenchMode>& GetModes() {
+  static const std::vector<BenchMode> modes = {
+      {"semaphore", {}},
+      {"seqlock", {ocm::ShmLockMode::SEQLOCK, ocm::ShmLayout::SINGLE}},
+      {"robust_mutex", {ocm::ShmLockMode::ROBUST_MUTEX, ocm::ShmLayout::SINGLE}},
+      {"ring", {ocm::ShmLockMode::SEQLOCK, ocm::ShmLayout::RING, 16}},
+      {"triple", {ocm::ShmLockMode::SEMAPHORE, ocm::ShmLayout::TRIPLE}},
+  };
+  return modes;
+}
+
+/**
+ * @brief 打印用法。
+ */
+void PrintUsage() {
+  printf(
+      "Usage: ocm_ipc_bench [options]\n"
+      "  --sizes <list>         Payload sizes in bytes, K/M suffixes allowed (default 64,256,1K,...,16M)\n"
+      "  --modes <list>         Segment modes: semaphore,seqlock,robust_mutex,ring,triple (default all)\n"
+      "  --apis <list>          Subscribe APIs: subscribe,nowait,owned (default all); owned reuses a caller-owned\n"
+      "                         message and fails the run if the steady-state receive path allocates\n"
+      "  --count <n>            Messages per run, reduced for large payloads (default 2000)\n"
+      "  --rate <hz>            Publish rate of latency runs (default 1000)\n"
+      "  --pub-cpu <cpu>        Pin the publisher process to a CPU\n"
+      "  --sub-cpu <cpu>        Pin the subscriber process to a CPU\n"
+      "  --notify <mode>        Notify mode: semaphore or futex (default semaphore)\n"
+      "  --output <file>        Write JSON results to a file instead of stdout\n");
+}
+
+/**
+ * @brief 按逗号拆分字符串。
+ */
+std::vector<std::string> Split(const std::string& text) {
+  std::vector<std::string> items;
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    size_t end = text.find(',', begin);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    if (end > begin) {
+      items.push_back(text.substr(begin, end - begin));
+    }
+    begin = end + 1;
+  }
+  return items;
+}
+
+/**
+ * @brief 解析带 K/M 后缀的字节数。
+ */
+size_t ParseSize(const std::string& text) {
+  char* end = nullptr;
+  size_t value = strtoull(text.c_str(), &end, 10);
+  if (*end == 'K' || *end == 'k') {
+    value <<= 10;
+  } else if (*end == 'M' || *end == 'm') {
+    value <<= 20;
+  }
+  return value;
+}
+
+/**
+ * @brief 解析命令行参数。
+ *
+ * @return 参数有效时返回 `true`。
+ */
+bool ParseArguments(int argc, char** argv, BenchConfig* config) {
+  for (size_t size = 64; size <= (16U << 20); size <<= 2) {
+    config->sizes.push_back(size);
+  }
+  for (const auto& mode : GetModes()) {
+    config->modes.push_back(mode.name);
+  }
+  config->apis = {"subscribe", "nowait", "owned"};
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[++i];
+    if (arg == "--sizes") {
+      config->sizes.clear();
+      for (const auto& item : Split(value)) {
+        config->sizes.push_back(ParseSize(item));
+      }
+    } else if (arg == "--modes") {
+      config->modes = Split(value);
+    } else if (arg == "--apis") {
+      config->apis = Split(value);
+    } else if (arg == "--count") {
+      config->count = strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--rate") {
+      config->rate = atof(value.c_str());
+    } else if (arg == "--pub-cpu") {
+      config->publisher_cpu = atoi(value.c_str());
+    } else if (arg == "--sub-cpu") {
+      config->subscriber_cpu = atoi(value.c_str());
+    } else if (arg == "--notify") {
+      config->notify_mode = value == "futex" ? ocm::ShmNotifyMode::FUTEX : ocm::ShmNotifyMode::SEMAPHORE;
+    } else if (arg == "--output") {
+      config->output = value;
+    } else {
+      return false;
+    }
+  }
+  for (const auto& name : config->modes) {
+    if (std::none_of(GetModes().begin(), GetModes().end(), [&](const BenchMode& mode) { return name == mode.name; })) {
+      fprintf(stderr, "ocm_ipc_bench: unknown mode \"%s\"\n", name.c_str());
+      return false;
+    }
+  }
+  for (const auto& api : config->apis) {
+    if (api != "subscribe" && api != "nowait" && api != "owned") {
+      fprintf(stderr, "ocm_ipc_bench: unknown api \"%s\"\n", api.c_str());
+      return false;
+    }
+  }
+  return !config->sizes.empty() && config->count > 0;
+}
+
+/**
+ * @brief 将当前进程绑定到指定 CPU。
+ */
+void PinToCpu(int cpu) {
+  if (cpu < 0) {
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    fprintf(stderr, "ocm_ipc_bench: failed to pin to cpu %d: %s\n", cpu, strerror(errno));
+  }
+}
+
+/**
+ * @brief 完整写入管道。
+ */
+void WriteAll(int fd, const void* data, size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written <= 0 && errno != EINTR) {
+      return;
+    }
+    if (written > 0) {
+      bytes += written;
+      size -= written;
+    }
+  }
+}
+
+/**
+ * @brief 完整读取管道。
+ *
+ * @return 读满 `size` 字节时返回 `true`。
+ */
+bool ReadAll(int fd, void* data, size_t size) {
+  auto* bytes = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    ssize_t got = read(fd, bytes, size);
+    if (got == 0 || (got < 0 && errno != EINTR)) {
+      return false;
+    }
+    if (got > 0) {
+      bytes += got;
+      size -= got;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 删除一次运行使用的共享内存段、信号量和通知段。
+ */
+void RemoveTopic(const std::string& topic_name, const std::string& shm_name) {
+  shm_unlink(ocm::GetNamePrefix(shm_name).c_str());
+  sem_unlink(ocm::GetNamePrefix(shm_name + "_shm").c_str());
+  sem_unlink(ocm::GetNamePrefix(topic_name).c_str());
+  shm_unlink(ocm::GetNamePrefix(topic_name + "_notify").c_str());
+}
+
+/**
+ * @brief 获取排序后延迟序列的分位数。
+ */
+uint64_t Percentile(const std::vector<uint64_t>& sorted, double ratio) {
+  size_t index = static_cast<size_t>(ratio * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * @brief 订阅者进程：接收消息直到结束消息，统计单向延迟。
+ */
+SubscriberReport RunSubscriber(const BenchRun& run, const ocm::SharedMemoryOption& option, const std::string& topic_name,
+                               const std::string& shm_name, BenchControl* control, int ready_fd) {
+  SubscriberReport report;
+  std::vector<uint64_t> latencies;
+  latencies.reserve(run.count);
+  bool done = false;
+  // 调用者持有消息的接口在环形布局下一次解码所有未读消息、只返回最新一条，被覆盖的消息按序号计入已接收
+  uint64_t collapsed = 0;
+  int64_t last_seq = -1;
+  uint64_t allocation_start = 0;
+  auto callback = [&](const BenchMessage& msg) {
+    uint64_t now = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    if (msg.seq == kWarmupSeq) {
+      control->ready.store(1, std::memory_order_release);
+      return;
+    }
+    if (msg.seq < 0) {
+      report.allocations = allocation_count.load(std::memory_order_relaxed) - allocation_start;
+      done = true;
+      return;
+    }
+    if (option.layout == ocm::ShmLayout::RING && msg.seq > last_seq + 1) {
+      collapsed += static_cast<uint64_t>(msg.seq - last_seq - 1);
+    }
+    last_seq = msg.seq;
+    latencies.push_back(now - static_cast<uint64_t>(msg.send_time));
+    control->received.store(latencies.size() + collapsed, std::memory_order_release);
+    if (report.first_time == 0) {
+      report.first_time = now;
+      allocation_start = allocation_count.load(std::memory_order_relaxed);
+    }
+    report.last_time = now;
+  };
+  try {
+    ocm::SharedMemoryTopicLcm topic;
+    topic.SetOption(shm_name, option);
+    // 先创建通知器再通知父进程启动发布者，避免错过最初的通知
+    topic.SubscribeNoWait<BenchMessage>(topic_name, shm_name, callback);
+    char ready = 1;
+    WriteAll(ready_fd, &ready, 1);
+    BenchMessage msg;
+    msg.data.reserve(run.size);
+    while (!done) {
+      if (run.api == "nowait") {
+        topic.SubscribeNoWait<BenchMessage>(topic_name, shm_name, callback);
+      } else if (run.api == "owned") {
+        topic.Subscribe(topic_name, shm_name, msg);
+        callback(msg);
+      } else {
+        topic.Subscribe<BenchMessage>(topic_name, shm_name, callback);
+      }
+    }
+    report.lock_stats = topic.GetReadLockStats(topic_name, shm_name);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "ocm_ipc_bench: subscriber failed: %s\n", e.what());
+    report.error = 1;
+  }
+  report.received = latencies.size() + collapsed;
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    uint64_t total = 0;
+    for (auto latency : latencies) {
+      total += latency;
+    }
+    report.latency_min = latencies.front();
+    report.latency_mean = total / latencies.size();
+    report.latency_p50 = Percentile(latencies, 0.5);
+    report.latency_p99 = Percentile(latencies, 0.99);
+    report.latency_p999 = Percentile(latencies, 0.999);
+    report.latency_max = latencies.back();
+  }
+  return report;
+}
+
+/**
+ * @brief 等待订阅者处理到 `count` 条消息。
+ *
+ * @return 在 `kDrainTimeout` 内处理到时返回 `true`。
+ */
+bool WaitReceived(const BenchControl* control, uint64_t count) {
+  const uint64_t deadline = ocm::SharedMemoryEndpoint::GetMonotonicTime() + kDrainTimeout * 1000000ULL;
+  while (control->received.load(std::memory_order_acquire) < count) {
+    if (ocm::SharedMemoryEndpoint::GetMonotonicTime() > deadline) {
+      return false;
+    }
+    sched_yield();
+  }
+  return true;
+}
+
+/**
+ * @brief 发布者进程：先完成预热握手，再按频率发送消息，最后发送结束消息。
+ *
+ * 吞吐测试不限速，但未处理的消息达到 `window` 条时等待订阅者，避免覆盖尚未读取的消息。
+ */
+PublisherReport RunPublisher(const BenchRun& run, const ocm::SharedMemoryOption& option, const std::string& topic_name,
+                             const std::string& shm_name, BenchControl* control) {
+  PublisherReport report;
+  try {
+    ocm::SharedMemoryTopicLcm topic;
+    topic.SetOption(shm_name, option);
+    BenchMessage msg;
+    msg.data.assign(run.size, 0x5a);
+    // 预热消息创建共享内存段，订阅者收到后才开始计时，最初的消息不会因订阅者尚未打开段或同步游标而丢失
+    msg.seq = kWarmupSeq;
+    const uint64_t warmup_deadline = ocm::SharedMemoryEndpoint::GetMonotonicTime() + kDrainTimeout * 1000000ULL;
+    while (!control->ready.load(std::memory_order_acquire)) {
+      if (ocm::SharedMemoryEndpoint::GetMonotonicTime() > warmup_deadline) {
+        throw std::runtime_error("subscriber did not receive the warm-up message");
+      }
+      topic.Publish(topic_name, shm_name, &msg);
+      usleep(kWarmupInterval / 1000);
+    }
+    // 单槽位和三缓冲布局只保留最新一条消息，吞吐测试逐条等待；环形布局留一个槽位的余量
+    const uint64_t window = option.layout == ocm::ShmLayout::RING ? std::max<uint64_t>(option.slot_count, 2) - 1 : 1;
+    uint64_t period = run.rate > 0 ? static_cast<uint64_t>(1e9 / run.rate) : 0;
+    report.start_time = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    for (uint64_t i = 0; i < run.count; ++i) {
+      if (period != 0) {
+        uint64_t wake = report.start_time + i * period;
+        timespec ts{static_cast<time_t>(wake / 1000000000ULL), static_cast<long>(wake % 1000000000ULL)};
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+      } else if (i >= window && !WaitReceived(control, i - window + 1)) {
+        throw std::runtime_error("subscriber stopped receiving");
+      }
+      msg.seq = static_cast<int64_t>(i);
+      msg.send_time = static_cast<int64_t>(ocm::SharedMemoryEndpoint::GetMonotonicTime());
+      topic.Publish(topic_name, shm_name, &msg);
+      ++report.sent;
+    }
+    report.end_time = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    report.lock_stats = topic.GetWriteLockStats(topic_name, shm_name);
+    // 结束消息不能覆盖最后一条消息：吞吐测试等待订阅者处理完，延迟测试再等待一个发送周期
+    if (period == 0) {
+      WaitReceived(control, run.count);
+    } else {
+      usleep(period / 1000);
+    }
+    msg.seq = -1;
+    topic.Publish(topic_name, shm_name, &msg);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "ocm_ipc_bench: publisher failed: %s\n", e.what());
+    report.error = 1;
+  }
+  return report;
+}
+
+/**
+ * @brief 等待子进程退出，超时后终止它。
+ *
+ * @return 子进程正常退出时返回 `true`。
+ */
+bool WaitChild(pid_t pid, int timeout) {
+  for (int elapsed = 0; elapsed <= timeout; elapsed += 10) {
+    int status = 0;
+    if (waitpid(pid, &status, WNOHANG) == pid) {
+      return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    usleep(10000);
+  }
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  return false;
+}
+
+/**
+ * @brief 执行一次运行：分别派生订阅者和发布者进程并收集结果。
+ *
+ * @return 两个进程都成功完成、订阅者至少收到一条消息、环形布局下没有丢失消息，
+ *         且 `owned` 接口的稳态接收没有堆分配时返回 `true`。
+ */
+bool Execute(const BenchRun& run, const BenchConfig& config, SubscriberReport* subscriber, PublisherReport* publisher) {
+  const std::string name = "ocm_bench_" + std::to_string(getpid());
+  const std::string topic_name = name, shm_name = name + "_data";
+  ocm::SharedMemoryOption option = run.mode->option;
+  option.notify_mode = config.notify_mode;
+  option.lock_stats = true;
+  if (option.layout != ocm::ShmLayout::SINGLE) {
+    // 环形和三缓冲布局按槽位容量创建，单槽位布局按首条消息的大小创建
+    option.capacity = BenchMessage().getEncodedSize() + run.size;
+  }
+  RemoveTopic(topic_name, shm_name);
+
+  void* shared = mmap(nullptr, sizeof(BenchControl), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared == MAP_FAILED) {
+    return false;
+  }
+  auto* control = new (shared) BenchControl{};
+  int sub_pipe[2], pub_pipe[2];
+  if (pipe(sub_pipe) != 0 || pipe(pub_pipe) != 0) {
+    munmap(shared, sizeof(BenchControl));
+    return false;
+  }
+  pid_t sub_pid = fork();
+  if (sub_pid == 0) {
+    close(sub_pipe[0]);
+    PinToCpu(config.subscriber_cpu);
+    auto report = RunSubscriber(run, option, topic_name, shm_name, control, sub_pipe[1]);
+    WriteAll(sub_pipe[1], &report, sizeof(report));
+    _exit(report.error);
+  }
+  close(sub_pipe[1]);
+  char ready = 0;
+  bool ok = ReadAll(sub_pipe[0], &ready, 1);
+  pid_t pub_pid = ok ? fork() : -1;
+  if (pub_pid == 0) {
+    close(pub_pipe[0]);
+    PinToCpu(config.publisher_cpu);
+    auto report = RunPublisher(run, option, topic_name, shm_name, control);
+    WriteAll(pub_pipe[1], &report, sizeof(report));
+    _exit(report.error);
+  }
+  close(pub_pipe[1]);
+  ok = ok && pub_pid > 0 && ReadAll(pub_pipe[0], publisher, sizeof(*publisher));
+  ok = ok && WaitChild(pub_pid, kDrainTimeout);
+  // 订阅者在收到结束消息后退出，超时说明结束消息丢失
+  ok = ReadAll(sub_pipe[0], subscriber, sizeof(*subscriber)) && ok;
+  ok = WaitChild(sub_pid, kDrainTimeout) && ok;
+  close(sub_pipe[0]);
+  close(pub_pipe[0]);
+  munmap(shared, sizeof(BenchControl));
+  RemoveTopic(topic_name, shm_name);
+  // 环形布局不应丢失消息；其他布局只保留最新一条，延迟测试允许少量覆盖，但至少要收到消息
+  bool lossless = option.layout == ocm::ShmLayout::RING || run.rate == 0;
+  bool complete = subscriber->received != 0 && (!lossless || subscriber->received >= publisher->sent);
+  bool allocation_free = run.api != "owned" || subscriber->allocations == 0;
+  return ok && complete && allocation_free && subscriber->error == 0 && publisher->error == 0;
+}
+
+/**
+ * @brief 输出一次运行的 JSON 结果。
+ */
+void PrintResult(FILE* out, const BenchRun& run, const char* kind, bool ok, const SubscriberReport& subscriber, const PublisherReport& publisher,
+                 bool first) {
+  double elapsed = subscriber.last_time > subscriber.first_time ? static_cast<double>(subscriber.last_time - subscriber.first_time) / 1e9 : 0.0;
+  double msgs_per_second = elapsed > 0 && subscriber.received > 1 ? static_cast<double>(subscriber.received - 1) / elapsed : 0.0;
+  auto average = [](const ocm::SharedMemoryLockStats& stats) { return stats.count ? stats.total_nanoseconds / stats.count : 0; };
+  fprintf(out, "%s\n    {\"mode\": \"%s\", \"api\": \"%s\", \"kind\": \"%s\", \"size\": %zu, \"ok\": %s,\n", first ? "" : ",", run.mode->name,
+          run.api.c_str(), kind, run.size, ok ? "true" : "false");
+  fprintf(out, "     \"sent\": %llu, \"received\": %llu, \"rate_hz\": %.1f, \"allocations\": %llu,\n",
+          static_cast<unsigned long long>(publisher.sent), static_cast<unsigned long long>(subscriber.received), run.rate,
+          static_cast<unsigned long long>(subscriber.allocations));
+  fprintf(out,
+          "     \"latency_ns\": {\"min\": %llu, \"mean\": %llu, \"p50\": %llu, \"p99\": %llu, \"p99.9\": %llu, \"max\": %llu},\n",
+          static_cast<unsigned long long>(subscriber.latency_min), static_cast<unsigned long long>(subscriber.latency_mean),
+          static_cast<unsigned long long>(subscriber.latency_p50), static_cast<unsigned long long>(subscriber.latency_p99),
+          static_cast<unsigned long long>(subscriber.latency_p999), static_cast<unsigned long long>(subscriber.latency_max));
+  double publish_elapsed = publisher.end_time > publisher.start_time ? static_cast<double>(publisher.end_time - publisher.start_time) / 1e9 : 0.0;
+  double publish_per_second = publish_elapsed > 0 ? static_cast<double>(publisher.sent) / publish_elapsed : 0.0;
+  fprintf(out, "     \"throughput\": {\"msgs_per_s\": %.1f, \"mb_per_s\": %.2f, \"publish_msgs_per_s\": %.1f},\n", msgs_per_second,
+          msgs_per_second * static_cast<double>(run.size) / (1024.0 * 1024.0), publish_per_second);
+  fprintf(out,
+          "     \"lock_hold_ns\": {\"read\": {\"count\": %llu, \"mean\": %llu, \"max\": %llu}, \"write\": {\"count\": %llu, \"mean\": %llu, \"max\": "
+          "%llu}}}",
+          static_cast<unsigned long long>(subscriber.lock_stats.count), static_cast<unsigned long long>(average(subscriber.lock_stats)),
+          static_cast<unsigned long long>(subscriber.lock_stats.max_nanoseconds), static_cast<unsigned long long>(publisher.lock_stats.count),
+          static_cast<unsigned long long>(average(publisher.lock_stats)), static_cast<unsigned long long>(publisher.lock_stats.max_nanoseconds));
+}
+
+}  // namespace
+
+/**
+ * @brief 替换全局分配函数以统计堆分配次数。
+ */
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, &config)) {
+    PrintUsage();
+    return 1;
+  }
+  FILE* out = config.output.empty() ? stdout : fopen(config.output.c_str(), "w");
+  if (!out) {
+    fprintf(stderr, "ocm_ipc_bench: cannot open \"%s\": %s\n", config.output.c_str(), strerror(errno));
+    return 1;
+  }
+  utsname host{};
+  uname(&host);
+  fprintf(out, "{\n  \"benchmark\": \"ocm_ipc_bench\",\n  \"host\": \"%s\",\n  \"kernel\": \"%s\",\n  \"cpus\": %ld,\n", host.nodename,
+          host.release, sysconf(_SC_NPROCESSORS_ONLN));
+  fprintf(out, "  \"publisher_cpu\": %d,\n  \"subscriber_cpu\": %d,\n  \"notify\": \"%s\",\n  \"results\": [", config.publisher_cpu,
+          config.subscriber_cpu, config.notify_mode == ocm::ShmNotifyMode::FUTEX ? "futex" : "semaphore");
+
+  int failures = 0;
+  bool first = true;
+  for (const auto& mode_name : config.modes) {
+    const auto& modes = GetModes();
+    const BenchMode& mode = *std::find_if(modes.begin(), modes.end(), [&](const BenchMode& mode) { return mode_name == mode.name; });
+    for (const auto& api : config.apis) {
+      for (size_t size : config.sizes) {
+        uint64_t count = std::max<uint64_t>(kMinMessages, std::min<uint64_t>(config.count, kMaxBytesPerRun / std::max<size_t>(size, 1)));
+        // 延迟测试按固定频率发送，吞吐测试不限速
+        for (double rate : {config.rate, 0.0}) {
+          BenchRun run{&mode, api, size, count, rate};
+          SubscriberReport subscriber;
+          PublisherReport publisher;
+          bool ok = Execute(run, config, &subscriber, &publisher);
+          failures += ok ? 0 : 1;
+          PrintResult(out, run, rate > 0 ? "latency" : "throughput", ok, subscriber, publisher, first);
+          first = false;
+          fflush(out);
+          fprintf(stderr, "%-12s %-9s %-10s %9zu B: p50 %8.1f us  p99 %8.1f us  max %8.1f us  received %llu/%llu  allocs %llu%s\n", mode.name,
+                  api.c_str(), rate > 0 ? "latency" : "throughput", size, subscriber.latency_p50 / 1e3, subscriber.latency_p99 / 1e3,
+                  subscriber.latency_max / 1e3, static_cast<unsigned long long>(subscriber.received),
+                  static_cast<unsigned long long>(publisher.sent), static_cast<unsigned long long>(subscriber.allocations), ok ? "" : "  FAILED");
+        }
+      }
+    }
+  }
+  fprintf(out, "\n  ]\n}\n");
+  if (out != stdout) {
+    fclose(out);
+  }
+  return failures == 0 ? 0 : 2;
+}
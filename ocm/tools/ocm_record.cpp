@@ -0,0 +1,350 @@
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "ocm/lcm_log.hpp"
+#include "ocm/shared_memory_batch.hpp"
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_registry.hpp"
+#include "ocm/shared_memory_tap.hpp"
+#include "ocm/shared_memory_wait_set.hpp"
+
+namespace {
+
+/**
+ * @brief 检查退出信号的间隔（毫秒）。
+ */
+constexpr int kPollInterval = 100;
+
+/**
+ * @brief 轮询信号量通知话题的间隔（毫秒）。
+ */
+constexpr int kSemaphorePollInterval = 1;
+
+/**
+ * @brief 扫描注册表中新话题和校准墙上时间的间隔（纳秒）。
+ */
+constexpr uint64_t kScanPeriod = 1000000000;
+
+/**
+ * @brief 退出标志，由 SIGINT 和 SIGTERM 设置。
+ */
+volatile std::sig_atomic_t stop_requested = 0;
+
+/**
+ * @brief 录制的话题。
+ */
+struct RecordTopic {
+  std::string topic_name;                    /**< 主题名，作为日志中的频道名。 */
+  std::string shm_name;                      /**< 共享内存段的名称。 */
+  bool batch = false;                        /**< 是否为批量发布的话题，录制时拆分为单条消息。 */
+  bool warned = false;                       /**< 是否已提示三缓冲布局的话题不录制。 */
+  std::unique_ptr<ocm::SharedMemoryTap> tap; /**< 话题的旁路读者。 */
+  uint64_t recorded = 0;                     /**< 已录制的消息数量。 */
+  uint64_t dropped = 0;                      /**< 因写缓冲区积压而丢弃的消息数量。 */
+};
+
+/**
+ * @brief 录制配置。
+ */
+struct RecordConfig {
+  std::string output;                                             /**< 日志文件路径。 */
+  std::vector<std::string> topics;                                /**< 话题描述，格式为 `topic[:shm]`，为空时录制注册表中的所有话题。 */
+  ocm::LcmLogWriterOption writer;                                 /**< 日志写入器选项。 */
+  uint64_t flush_interval = 500000000;                            /**< 未满的写缓冲区最多停留的时间（纳秒）。 */
+  double duration = 0.0;                                          /**< 录制时长（秒），为 0 时直到收到退出信号。 */
+  ocm::ShmNotifyMode notify_mode = ocm::ShmNotifyMode::SEMAPHORE; /**< 注册表中找不到话题时使用的通知方式。 */
+};
+
+/**
+ * @brief 打印用法。
+ */
+void PrintUsage() {
+  printf(
+      "Usage: ocm-record --output <file> [--topic <topic[:shm]> ...] [options]\n"
+      "  --output <file>          LCM log file to write\n"
+      "  --topic <topic[:shm]>    topic to record, may be repeated (default: every topic in the registry, including new ones)\n"
+      "  --buffer <MiB>           size of each write buffer (default 4)\n"
+      "  --buffers <n>            number of write buffers; messages are dropped when all are queued (default 16)\n"
+      "  --preallocate <MiB>      file space to preallocate ahead of the writer, 0 to disable (default 256)\n"
+      "  --flush <ms>             hand a partial buffer to the writer after this long (default 500)\n"
+      "  --duration <seconds>     stop after this long (default: until interrupted)\n"
+      "  --no-index               do not write the <file>.idx sidecar index\n"
+      "  --notify <mode>          semaphore or futex, used for topics not found in the registry (default semaphore)\n"
+      "Semaphore topics are polled every 1 ms instead of taking notifications from their subscribers: by message\n"
+      "sequence, or for raw segments by content change, so repeated identical raw payloads are recorded once.\n"
+      "Triple-layout topics allow a single reader and are skipped.\n");
+}
+
+/**
+ * @brief 解析命令行参数。
+ *
+ * @return 参数有效时返回 `true`。
+ */
+bool ParseArguments(int argc, char** argv, RecordConfig* config) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--no-index") {
+      config->writer.write_index = false;
+      continue;
+    }
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[++i];
+    if (arg == "--output" || arg == "-o") {
+      config->output = value;
+    } else if (arg == "--topic") {
+      config->topics.push_back(value);
+    } else if (arg == "--buffer") {
+      config->writer.buffer_size = strtoull(value.c_str(), nullptr, 10) << 20;
+    } else if (arg == "--buffers") {
+      config->writer.buffer_count = strtoull(value.c_str(), nullptr, 10);
+    } else if (arg == "--preallocate") {
+      config->writer.preallocate_size = strtoull(value.c_str(), nullptr, 10) << 20;
+    } else if (arg == "--flush") {
+      config->flush_interval = strtoull(value.c_str(), nullptr, 10) * 1000000;
+    } else if (arg == "--duration") {
+      config->duration = atof(value.c_str());
+    } else if (arg == "--notify") {
+      config->notify_mode = value == "futex" ? ocm::ShmNotifyMode::FUTEX : ocm::ShmNotifyMode::SEMAPHORE;
+    } else {
+      return false;
+    }
+  }
+  return !config->output.empty() && config->writer.buffer_size > 0;
+}
+
+/**
+ * @brief 获取 `CLOCK_REALTIME` 与 `CLOCK_MONOTONIC` 之差（纳秒），用于将消息的发布时刻换算为日志的墙上时间。
+ */
+int64_t GetRealtimeOffset() {
+  timespec realtime;
+  clock_gettime(CLOCK_REALTIME, &realtime);
+  int64_t now = static_cast<int64_t>(realtime.tv_sec) * 1000000000 + realtime.tv_nsec;
+  return now - static_cast<int64_t>(ocm::SharedMemoryEndpoint::GetMonotonicTime());
+}
+
+/**
+ * @class Recorder
+ * @brief 在等待集上等待所有录制话题，将每条新消息写入日志。
+ */
+class Recorder {
+ public:
+  /**
+   * @brief 构造录制器。
+   *
+   * @param config 录制配置。
+   *
+   * @throws std::runtime_error 如果创建日志文件失败。
+   */
+  explicit Recorder(const RecordConfig& config) : config_(config), writer_(config.output, config.writer) {}
+
+  /**
+   * @brief 加入一个话题。
+   *
+   * 话题已在录制时不做任何操作。注册表中有该话题时使用其通知方式，批量发布的话题按单条消息录制。
+   * futex 通知的话题加入等待集，信号量通知的话题定期轮询，读取方式见 `SharedMemoryTap`。
+   *
+   * @param topic_name 主题名。
+   * @param shm_name 共享内存段的名称。
+   */
+  void AddTopic(const std::string& topic_name, const std::string& shm_name) {
+    if (!names_.insert(topic_name).second) {
+      return;
+    }
+    auto topic = std::make_unique<RecordTopic>();
+    topic->topic_name = topic_name;
+    topic->shm_name = shm_name;
+    auto mode = config_.notify_mode;
+    auto& registry = ocm::SharedMemoryRegistry::getInstance();
+    ocm::SharedMemoryTopicInfo info;
+    if (registry.IsAvailable() && registry.Find(topic_name, &info)) {
+      mode = info.option.notify_mode;
+      topic->batch = info.type_name.size() > 2 && info.type_name.compare(info.type_name.size() - 2, 2, "[]") == 0;
+    }
+    topic->tap = std::make_unique<ocm::SharedMemoryTap>(topic_name, shm_name, mode);
+    if (topic->tap->IsPolled()) {
+      polled_.push_back(topic.get());
+    } else {
+      wait_set_.Attach(topic->tap->GetNotifier());
+      waited_.push_back(topic.get());
+    }
+    topics_.push_back(std::move(topic));
+  }
+
+  /**
+   * @brief 加入注册表中尚未录制的话题。
+   */
+  void ScanRegistry() {
+    auto& registry = ocm::SharedMemoryRegistry::getInstance();
+    if (!registry.IsAvailable()) {
+      return;
+    }
+    for (const auto& info : registry.List()) {
+      AddTopic(info.topic_name, info.shm_name);
+    }
+  }
+
+  /**
+   * @brief 录制直到收到退出信号或到达录制时长。
+   *
+   * @param scan 是否定期扫描注册表中的新话题。
+   */
+  void Run(bool scan) {
+    const uint64_t start = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    const uint64_t end = config_.duration > 0 ? start + static_cast<uint64_t>(config_.duration * 1e9) : 0;
+    uint64_t next_scan = start + kScanPeriod;
+    uint64_t flush_time = start;
+    realtime_offset_ = GetRealtimeOffset();
+    while (!stop_requested) {
+      const int timeout = polled_.empty() ? kPollInterval : kSemaphorePollInterval;
+      if (!waited_.empty()) {
+        for (size_t index : wait_set_.WaitTimeout(timeout)) {
+          Record(*waited_[index], false);
+        }
+      } else {
+        usleep(timeout * 1000);
+      }
+      for (auto* topic : polled_) {
+        Record(*topic, true);
+      }
+      const uint64_t now = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+      if (end != 0 && now >= end) {
+        break;
+      }
+      if (now - flush_time >= config_.flush_interval) {
+        writer_.Flush();
+        flush_time = now;
+      }
+      if (now >= next_scan) {
+        if (scan) {
+          ScanRegistry();
+        }
+        realtime_offset_ = GetRealtimeOffset();
+        next_scan = now + kScanPeriod;
+      }
+    }
+    writer_.Close();
+  }
+
+  /**
+   * @brief 打印录制统计。
+   */
+  void PrintStats() const {
+    for (const auto& topic : topics_) {
+      if (topic->tap->IsExcluded()) {
+        fprintf(stderr, "ocm-record: %s skipped, triple layout\n", topic->topic_name.c_str());
+        continue;
+      }
+      fprintf(stderr, "ocm-record: %s recorded %llu, dropped %llu, overrun %llu\n", topic->topic_name.c_str(),
+              static_cast<unsigned long long>(topic->recorded), static_cast<unsigned long long>(topic->dropped),
+              static_cast<unsigned long long>(topic->tap->GetEndpoint().GetDroppedCount()));
+    }
+    fprintf(stderr, "ocm-record: %llu events, %llu bytes written to %s, %llu dropped\n", static_cast<unsigned long long>(writer_.GetEventCount()),
+            static_cast<unsigned long long>(writer_.GetWrittenBytes()), config_.output.c_str(),
+            static_cast<unsigned long long>(writer_.GetDroppedCount()));
+    std::string error = writer_.GetError();
+    if (!error.empty()) {
+      fprintf(stderr, "ocm-record: %s\n", error.c_str());
+    }
+  }
+
+ private:
+  /**
+   * @brief 读取话题的所有新消息并追加到日志。
+   *
+   * @param topic 录制的话题。
+   * @param polled 是否为轮询的信号量通知话题，否则为等待集中就绪的话题。
+   */
+  void Record(RecordTopic& topic, bool polled) {
+    auto& endpoint = topic.tap->GetEndpoint();
+    auto reader = [&](const uint8_t* data, size_t size) {
+      // 以发布时刻作为事件时间戳，裸数据段没有发布时刻时使用读取时刻
+      uint64_t timestamp = endpoint.GetMessageHeader().timestamp;
+      if (timestamp == 0) {
+        timestamp = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+      }
+      int64_t utime = (static_cast<int64_t>(timestamp) + realtime_offset_) / 1000;
+      auto append = [&](const uint8_t* message, size_t message_size) {
+        if (writer_.Append(topic.topic_name, utime, message, message_size)) {
+          ++topic.recorded;
+        } else {
+          ++topic.dropped;
+        }
+      };
+      if (!topic.batch) {
+        append(data, size);
+        return;
+      }
+      try {
+        ocm::ForEachBatchMessage(data, size, append);
+      } catch (const std::exception&) {
+        ++topic.dropped;
+      }
+    };
+    if (polled) {
+      topic.tap->Poll(reader);
+    } else {
+      topic.tap->ReadReady(reader);
+    }
+    if (topic.tap->IsExcluded() && !topic.warned) {
+      topic.warned = true;
+      fprintf(stderr, "ocm-record: %s uses the triple layout, which allows a single reader; not recording it\n", topic.topic_name.c_str());
+    }
+  }
+
+  const RecordConfig& config_;                       /**< 录制配置。 */
+  ocm::LcmLogWriter writer_;                         /**< 日志写入器。 */
+  ocm::SharedMemoryWaitSet wait_set_;                /**< futex 通知话题的等待集，条目索引与 `waited_` 一致。 */
+  std::vector<std::unique_ptr<RecordTopic>> topics_; /**< 录制的话题。 */
+  std::vector<RecordTopic*> waited_;                 /**< futex 通知的话题，索引与等待集的条目一致。 */
+  std::vector<RecordTopic*> polled_;                 /**< 信号量通知的话题，按消息序号轮询。 */
+  std::unordered_set<std::string> names_;            /**< 已录制的主题名。 */
+  int64_t realtime_offset_ = 0;                      /**< `CLOCK_REALTIME` 与 `CLOCK_MONOTONIC` 之差（纳秒）。 */
+};
+
+/**
+ * @brief 退出信号处理函数。
+ */
+void HandleSignal(int) { stop_requested = 1; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  RecordConfig config;
+  config.writer.write_index = true;
+  if (!ParseArguments(argc, argv, &config)) {
+    PrintUsage();
+    return 1;
+  }
+  struct sigaction action {};
+  action.sa_handler = HandleSignal;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+  try {
+    Recorder recorder(config);
+    for (const auto& spec : config.topics) {
+      size_t colon = spec.find(':');
+      std::string topic_name = spec.substr(0, colon);
+      recorder.AddTopic(topic_name, colon == std::string::npos ? topic_name : spec.substr(colon + 1));
+    }
+    const bool scan = config.topics.empty();
+    if (scan) {
+      recorder.ScanRegistry();
+    }
+    recorder.Run(scan);
+    recorder.PrintStats();
+  } catch (const std::exception& e) {
+    fprintf(stderr, "ocm-record: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,308 @@
+#include <signal.h>
+#include <time.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ocm/lcm_log.hpp"
+#include "ocm/shared_memory_registry.hpp"
+#include "ocm/shared_memory_topic_lcm.hpp"
+
+namespace {
+
+/**
+ * @brief 回放时提前预读的日志字节数。
+ */
+constexpr size_t kPrefetchWindow = 64 << 20;
+
+/**
+ * @brief 判定事件发布延迟的阈值（纳秒）。
+ */
+constexpr uint64_t kLateThreshold = 1000000;
+
+/**
+ * @brief 按订阅者进度回放时，等待上一条消息被取走的最长时间（纳秒），超时后照常发布。
+ */
+constexpr uint64_t kPaceTimeout = 1000000000;
+
+/**
+ * @brief 按订阅者进度回放时轮询的间隔（纳秒）。
+ */
+constexpr uint64_t kPacePollInterval = 20000;
+
+/**
+ * @brief 退出标志，由 SIGINT 和 SIGTERM 设置。
+ */
+volatile std::sig_atomic_t stop_requested = 0;
+
+/**
+ * @brief 已编码的 LCM 消息，直接指向映射的日志文件。
+ *
+ * 满足 `LcmSerializer` 对消息类型的要求，发布时将编码数据原样拷贝到共享内存。
+ * 日志中没有类型信息，类型哈希为 0，订阅者不检查类型。
+ */
+struct EncodedLcmMessage {
+  const uint8_t* data = nullptr; /**< 编码数据。 */
+  uint32_t size = 0;             /**< 编码数据的字节数。 */
+
+  /**
+   * @brief 将编码数据拷贝到 `buf`。
+   */
+  int encode(void* buf, int offset, int maxlen) const {
+    if (maxlen < 0 || size > static_cast<uint32_t>(maxlen)) {
+      return -1;
+    }
+    memcpy(static_cast<uint8_t*>(buf) + offset, data, size);
+    return static_cast<int>(size);
+  }
+
+  /**
+   * @brief 获取编码数据的字节数。
+   */
+  int getEncodedSize() const { return static_cast<int>(size); }
+
+  /**
+   * @brief 获取类型哈希，0 表示不检查。
+   */
+  static int64_t getHash() { return 0; }
+
+  /**
+   * @brief 获取类型名称，日志中没有类型信息，为空。
+   */
+  static const char* getTypeName() { return ""; }
+};
+
+/**
+ * @brief 回放配置。
+ */
+struct ReplayConfig {
+  std::string path;                                               /**< 日志文件路径。 */
+  double speed = 1.0;                                             /**< 回放速度倍数，为 0 时不等待，尽快发布。 */
+  double start = 0.0;                                             /**< 从日志开始后的第几秒开始回放。 */
+  bool loop = false;                                              /**< 是否循环回放。 */
+  bool paced = false;                                             /**< 是否等待订阅者取走频道的上一条消息后再发布下一条。 */
+  std::vector<std::string> channels;                              /**< 只回放这些频道，为空时回放所有频道。 */
+  std::string prefix;                                             /**< 发布时主题名和共享内存段名称的前缀。 */
+  ocm::SharedMemoryOption option;                                 /**< 创建共享内存段的选项，容量按频道的最大事件长度设置。 */
+  ocm::ShmNotifyMode notify_mode = ocm::ShmNotifyMode::SEMAPHORE; /**< 注册表中找不到话题时使用的通知方式。 */
+};
+
+/**
+ * @brief 打印用法。
+ */
+void PrintUsage() {
+  printf(
+      "Usage: ocm-replay <logfile> [options]\n"
+      "  --speed <x>          playback speed relative to recording time, e.g. 10 (default 1)\n"
+      "  --fast               publish back to back without timestamp pacing\n"
+      "  --paced              before publishing on a channel, wait (up to 1 s) until a subscriber has taken\n"
+      "                       the previous message on it; combine with --fast to replay as fast as consumers keep up.\n"
+      "                       With futex notification a running ocm-record or ocm-bridge also takes messages, so\n"
+      "                       pacing then follows the fastest reader rather than the slowest\n"
+      "  --start <seconds>    skip this far into the log\n"
+      "  --loop               restart from the beginning when the log ends\n"
+      "  --channel <name>     only replay this channel, may be repeated\n"
+      "  --prefix <text>      prepend to topic and shm names\n"
+      "  --ring <slots>       create segments with a ring of this many slots (default single slot)\n"
+      "  --notify <mode>      semaphore or futex, used for topics not found in the registry (default semaphore)\n");
+}
+
+/**
+ * @brief 解析命令行参数。
+ *
+ * @return 参数有效时返回 `true`。
+ */
+bool ParseArguments(int argc, char** argv, ReplayConfig* config) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      return false;
+    } else if (arg == "--fast") {
+      config->speed = 0.0;
+    } else if (arg == "--paced") {
+      config->paced = true;
+    } else if (arg == "--loop") {
+      config->loop = true;
+    } else if (arg.rfind("--", 0) != 0) {
+      config->path = arg;
+    } else if (i + 1 >= argc) {
+      return false;
+    } else {
+      std::string value = argv[++i];
+      if (arg == "--speed") {
+        config->speed = atof(value.c_str());
+      } else if (arg == "--start") {
+        config->start = atof(value.c_str());
+      } else if (arg == "--channel") {
+        config->channels.push_back(value);
+      } else if (arg == "--prefix") {
+        config->prefix = value;
+      } else if (arg == "--ring") {
+        config->option.layout = ocm::ShmLayout::RING;
+        config->option.slot_count = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+      } else if (arg == "--notify") {
+        config->notify_mode = value == "futex" ? ocm::ShmNotifyMode::FUTEX : ocm::ShmNotifyMode::SEMAPHORE;
+      } else {
+        return false;
+      }
+    }
+  }
+  return !config->path.empty() && config->speed >= 0.0;
+}
+
+/**
+ * @brief 获取话题的通知方式：优先使用注册表中记录的设置。
+ */
+ocm::ShmNotifyMode GetNotifyMode(const std::string& topic_name, ocm::ShmNotifyMode fallback) {
+  auto& registry = ocm::SharedMemoryRegistry::getInstance();
+  ocm::SharedMemoryTopicInfo info;
+  return registry.IsAvailable() && registry.Find(topic_name, &info) ? info.option.notify_mode : fallback;
+}
+
+/**
+ * @brief 等待到 `CLOCK_MONOTONIC` 下的绝对时刻。
+ */
+void SleepUntil(uint64_t deadline) {
+  timespec time{static_cast<time_t>(deadline / 1000000000), static_cast<long>(deadline % 1000000000)};
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr) == EINTR && !stop_requested) {
+  }
+}
+
+/**
+ * @brief 等待订阅者取走发布者的上一条消息。
+ *
+ * @return 在 `kPaceTimeout` 内被取走或收到退出信号时返回 `true`。
+ */
+bool WaitConsumed(const ocm::SharedMemoryPublisherLcm<EncodedLcmMessage>& publisher) {
+  const uint64_t deadline = ocm::SharedMemoryEndpoint::GetMonotonicTime() + kPaceTimeout;
+  while (!publisher.IsConsumed() && !stop_requested) {
+    if (ocm::SharedMemoryEndpoint::GetMonotonicTime() >= deadline) {
+      return false;
+    }
+    timespec interval{0, static_cast<long>(kPacePollInterval)};
+    nanosleep(&interval, nullptr);
+  }
+  return true;
+}
+
+/**
+ * @brief 退出信号处理函数。
+ */
+void HandleSignal(int) { stop_requested = 1; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ReplayConfig config;
+  if (!ParseArguments(argc, argv, &config)) {
+    PrintUsage();
+    return 1;
+  }
+  struct sigaction action {};
+  action.sa_handler = HandleSignal;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+  try {
+    ocm::LcmLogReader reader(config.path);
+    const uint64_t index_start = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    // 优先使用录制时写入的旁路索引，没有时扫描日志建立索引并保存，下次回放无需扫描
+    const std::string index_path = ocm::GetLcmLogIndexPath(config.path);
+    const char* index_source = "loaded";
+    if (!reader.LoadIndex(index_path)) {
+      reader.BuildIndex();
+      index_source = reader.SaveIndex(index_path) ? "built and saved" : "built";
+    }
+    const auto index = reader.GetIndex();
+    const auto& channels = reader.GetChannels();
+    if (index.empty()) {
+      fprintf(stderr, "ocm-replay: no events in %s\n", config.path.c_str());
+      return 1;
+    }
+
+    // 按频道的最大事件长度创建发布者，发布时不再按频道名查找
+    std::vector<uint32_t> max_size(channels.size(), 0);
+    for (const auto& entry : index) {
+      max_size[entry.channel] = std::max(max_size[entry.channel], entry.size);
+    }
+    std::vector<std::unique_ptr<ocm::SharedMemoryPublisherLcm<EncodedLcmMessage>>> publishers(channels.size());
+    for (size_t i = 0; i < channels.size(); ++i) {
+      if (!config.channels.empty() && std::find(config.channels.begin(), config.channels.end(), channels[i]) == config.channels.end()) {
+        continue;
+      }
+      const std::string name = config.prefix + channels[i];
+      ocm::SharedMemoryOption option = config.option;
+      option.capacity = std::max<size_t>(max_size[i], 1);
+      option.notify_mode = GetNotifyMode(name, config.notify_mode);
+      publishers[i] = std::make_unique<ocm::SharedMemoryPublisherLcm<EncodedLcmMessage>>(name, name, option);
+    }
+    fprintf(stderr, "ocm-replay: %s index of %zu events on %zu channels in %.3f s\n", index_source, index.size(), channels.size(),
+            (ocm::SharedMemoryEndpoint::GetMonotonicTime() - index_start) * 1e-9);
+
+    const size_t first = reader.FindTime(index.front().timestamp + static_cast<int64_t>(config.start * 1e6));
+    if (first >= index.size()) {
+      fprintf(stderr, "ocm-replay: --start is past the end of %s\n", config.path.c_str());
+      return 1;
+    }
+    uint64_t published = 0;
+    uint64_t late = 0;
+    uint64_t max_lateness = 0;
+    uint64_t unconsumed = 0;
+    const uint64_t replay_start = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+    do {
+      // 每一轮以该轮首个事件的时间戳为零点，事件的发布时刻只由时间戳决定，不累积等待误差
+      const uint64_t base_time = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+      const int64_t base_timestamp = index[first].timestamp;
+      uint64_t prefetched = index[first].offset;
+      for (size_t i = first; i < index.size() && !stop_requested; ++i) {
+        const auto& entry = index[i];
+        auto& publisher = publishers[entry.channel];
+        if (!publisher) {
+          continue;
+        }
+        if (entry.offset >= prefetched) {
+          reader.Prefetch(entry.offset, kPrefetchWindow);
+          prefetched = entry.offset + kPrefetchWindow / 2;
+        }
+        if (config.speed > 0.0) {
+          // 时间戳回退的事件立即发布
+          uint64_t delay = static_cast<uint64_t>(std::max<int64_t>(entry.timestamp - base_timestamp, 0) * 1000 / config.speed);
+          uint64_t now = ocm::SharedMemoryEndpoint::GetMonotonicTime();
+          if (base_time + delay > now) {
+            SleepUntil(base_time + delay);
+          } else if (now - (base_time + delay) > kLateThreshold) {
+            ++late;
+            max_lateness = std::max(max_lateness, now - (base_time + delay));
+          }
+        }
+        ocm::LcmLogEvent event;
+        if (!reader.ReadEventAt(i, &event)) {
+          continue;
+        }
+        // 共享内存段只保留最近的消息，订阅者跟不上时等待其取走上一条，避免覆盖未读消息
+        if (config.paced && !WaitConsumed(*publisher)) {
+          ++unconsumed;
+        }
+        publisher->Publish(EncodedLcmMessage{event.data, event.size});
+        ++published;
+      }
+    } while (config.loop && !stop_requested);
+
+    double elapsed = (ocm::SharedMemoryEndpoint::GetMonotonicTime() - replay_start) * 1e-9;
+    fprintf(stderr, "ocm-replay: published %llu events in %.3f s (%.0f events/s), %llu more than 1 ms late (max %.3f ms)\n",
+            static_cast<unsigned long long>(published), elapsed, elapsed > 0 ? published / elapsed : 0.0, static_cast<unsigned long long>(late),
+            max_lateness * 1e-6);
+    if (config.paced) {
+      fprintf(stderr, "ocm-replay: %llu events published after waiting %.0f s for the previous one to be taken\n",
+              static_cast<unsigned long long>(unconsumed), kPaceTimeout * 1e-9);
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "ocm-replay: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
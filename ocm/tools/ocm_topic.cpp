@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "ocm/shared_memory_endpoint.hpp"
+#include "ocm/shared_memory_registry.hpp"
+
+namespace {
+
+/**
+ * @brief 打印用法。
+ */
+void PrintUsage() {
+  printf(
+      "Usage: ocm-topic <command> [args]\n"
+      "  list                     List registered shared memory topics\n"
+      "  info <topic>             Show details of a topic\n"
+      "  reclaim [idle_seconds]   Remove topics without live processes that have been idle (default 60 s)\n"
+      "  reset                    Remove the registry segment itself\n");
+}
+
+/**
+ * @brief 获取锁模式的名称。
+ */
+const char* ToString(ocm::ShmLockMode mode) {
+  switch (mode) {
+    case ocm::ShmLockMode::SEQLOCK:
+      return "seqlock";
+    case ocm::ShmLockMode::ROBUST_MUTEX:
+      return "robust_mutex";
+    default:
+      return "semaphore";
+  }
+}
+
+/**
+ * @brief 获取数据布局的名称。
+ */
+const char* ToString(ocm::ShmLayout layout) {
+  switch (layout) {
+    case ocm::ShmLayout::RING:
+      return "ring";
+    case ocm::ShmLayout::TRIPLE:
+      return "triple";
+    default:
+      return "single";
+  }
+}
+
+/**
+ * @brief 获取通知方式的名称。
+ */
+const char* ToString(ocm::ShmNotifyMode mode) { return mode == ocm::ShmNotifyMode::FUTEX ? "futex" : "semaphore"; }
+
+/**
+ * @brief 获取距最近一次发布的秒数，尚未发布时返回负数。
+ */
+double GetIdleSeconds(const ocm::SharedMemoryTopicInfo& info) {
+  if (info.last_publish_time == 0) {
+    return -1.0;
+  }
+  return static_cast<double>(ocm::SharedMemoryEndpoint::GetMonotonicTime() - info.last_publish_time) / 1e9;
+}
+
+/**
+ * @brief 列出所有话题。
+ */
+int List(ocm::SharedMemoryRegistry& registry) {
+  printf("%-32s %-32s %-24s %10s %4s %4s %10s %8s\n", "TOPIC", "SHM", "TYPE", "CAPACITY", "PUB", "SUB", "RATE(Hz)", "IDLE(s)");
+  for (const auto& info : registry.List()) {
+    double idle = GetIdleSeconds(info);
+    printf("%-32s %-32s %-24s %10zu %4zu %4u %10.1f ", info.topic_name.c_str(), info.shm_name.c_str(), info.type_name.c_str(), info.option.capacity,
+           info.publisher_pids.size(), info.subscriber_count, info.publish_rate);
+    if (idle < 0) {
+      printf("%8s\n", "-");
+    } else {
+      printf("%8.1f\n", idle);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief 打印话题详情。
+ */
+int Info(ocm::SharedMemoryRegistry& registry, const std::string& topic_name) {
+  ocm::SharedMemoryTopicInfo info;
+  if (!registry.Find(topic_name, &info)) {
+    fprintf(stderr, "ocm-topic: topic \"%s\" is not registered\n", topic_name.c_str());
+    return 1;
+  }
+  printf("topic:        %s\n", info.topic_name.c_str());
+  printf("shm:          %s\n", info.shm_name.c_str());
+  printf("type:         %s (hash %lld)\n", info.type_name.c_str(), static_cast<long long>(info.type_hash));
+  printf("lock mode:    %s\n", ToString(info.option.lock_mode));
+  printf("layout:       %s", ToString(info.option.layout));
+  if (info.option.layout == ocm::ShmLayout::RING) {
+    printf(" (%u slots)", info.option.slot_count);
+  }
+  printf("\nnotify mode:  %s\n", ToString(info.option.notify_mode));
+  printf("capacity:     %zu bytes\n", info.option.capacity);
+  printf("publishers:  ");
+  for (auto pid : info.publisher_pids) {
+    printf(" %d", pid);
+  }
+  printf("\nsubscribers:  %u\n", info.subscriber_count);
+  printf("published:    %llu\n", static_cast<unsigned long long>(info.publish_count));
+  printf("rate:         %.1f Hz\n", info.publish_rate);
+  double idle = GetIdleSeconds(info);
+  if (idle >= 0) {
+    printf("idle:         %.1f s\n", idle);
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    PrintUsage();
+    return 1;
+  }
+  const std::string command = argv[1];
+  if (command == "reset") {
+    ocm::SharedMemoryRegistry::Destroy();
+    return 0;
+  }
+  auto& registry = ocm::SharedMemoryRegistry::getInstance();
+  if (!registry.IsAvailable()) {
+    fprintf(stderr, "ocm-topic: registry is not available, try \"ocm-topic reset\"\n");
+    return 1;
+  }
+  if (command == "list") {
+    return List(registry);
+  }
+  if (command == "info" && argc >= 3) {
+    return Info(registry, argv[2]);
+  }
+  if (command == "reclaim") {
+    double idle_seconds = argc >= 3 ? atof(argv[2]) : 60.0;
+    for (const auto& topic_name : registry.Reclaim(static_cast<uint64_t>(idle_seconds * 1e9))) {
+      printf("reclaimed %s\n", topic_name.c_str());
+    }
+    return 0;
+  }
+  PrintUsage();
+  return 1;
+}